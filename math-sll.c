@@ -52,6 +52,15 @@ static sll _sllsin(sll x);
 
 static sll _sllexp(sll x);
 
+static sll _sllratio(sll x, sll y);
+static __inline__ sll _sllabs(sll x);
+static int _sllbits(ull u);
+
+static void _sllmul128(sll x, sll y, sll *hi, ull *lo);
+static void _sllumul128(ull x, ull y, ull *hi, ull *lo);
+static __inline__ void _sllaccadd128(sllacc *a, sll hi, ull lo);
+static sll _sllaccshift(const sllacc *a, int s);
+
 /*
  * Unpack IEEE 754 floating point double format into fixed point sll format
  *
@@ -263,6 +272,88 @@ sll sllmul(sll x, sll y)
 
 #endif /* !defined(HAVE_SLLMUL)! */
 
+/*
+ * Full 128 bit product of two sll values
+ *
+ * Description
+ *
+ *	The raw product has 64 bits on either side of the decimal, 64.64,
+ *	returned as a signed high half and an unsigned low half.
+ *
+ *	The unsigned product is built from four 32 x 32 bit products, then
+ *	corrected for the signs, since reading a negative 64 bit value as
+ *	unsigned adds 2^64:
+ *
+ *	(x + 2^64) * y = x * y + y * 2^64
+ */
+
+static void _sllmul128(sll x, sll y, sll *hi, ull *lo)
+{
+	ull ll, lh, hl, hh;
+	ull mid;
+
+	ll = (ull) (unsigned) x * (unsigned) y;
+	lh = (ull) (unsigned) x * (unsigned) ((ull) y >> 32);
+	hl = (ull) (unsigned) ((ull) x >> 32) * (unsigned) y;
+	hh = (ull) (unsigned) ((ull) x >> 32) * (unsigned) ((ull) y >> 32);
+
+	mid = (ll >> 32) + (unsigned) lh + (unsigned) hl;
+
+	*lo = (mid << 32) | (unsigned) ll;
+	*hi = (sll) (hh + (lh >> 32) + (hl >> 32) + (mid >> 32));
+
+	if (x < 0)
+		*hi -= y;
+	if (y < 0)
+		*hi -= x;
+}
+
+/*
+ * Full 128 bit product of two unsigned 64 bit values
+ *
+ * Description
+ *
+ *	The product of _sllmul128() without its corrections for the signs.
+ */
+
+static void _sllumul128(ull x, ull y, ull *hi, ull *lo)
+{
+	sll h;
+
+	_sllmul128((sll) x, (sll) y, &h, lo);
+	*hi = (ull) h;
+
+	if ((sll) x < 0)
+		*hi += y;
+	if ((sll) y < 0)
+		*hi += x;
+}
+
+/*
+ * Saturating multiply
+ *
+ * Description
+ *
+ *	The 32.32 result is the middle 64 bits of the 64.64 product, so it
+ *	fits if and only if the high half of the product is the sign
+ *	extension of bit 31 of itself.
+ */
+
+sll sllmulsat(sll x, sll y)
+{
+	sll hi;
+	ull lo;
+
+	_sllmul128(x, y, &hi, &lo);
+
+	if (hi >= 0x0000000080000000LL)
+		return CONST_MAX;
+	if (hi < -0x0000000080000000LL)
+		return CONST_MIN;
+
+	return (sll) (((ull) hi << 32) | (lo >> 32));
+}
+
 /*
  * Calculate cos x where -pi/4 <= x <= pi/4
  *
@@ -449,6 +540,186 @@ sll slltan(sll x)
 	return retval;
 }
 
+/*
+ * Calculate sin x and cos x together for any value of x, by quadrant
+ *
+ * Description
+ *
+ *	Both series share the same argument reduction, so computing them
+ *	together costs one reduction instead of two.
+ */
+
+void sllsincos(sll x, sll *s, sll *c)
+{
+	int i;
+	sll sn;
+	sll cs;
+
+	i = _sll2int(_slladd(sllmul(x, CONST_2_PI), CONST_1_2));
+	x = _sllsub(x, sllmul(_int2sll(i), CONST_PI_2));
+
+	sn = _sllsin(x);
+	cs = _sllcos(x);
+
+	/* Locate the quadrant */
+	switch (i & 3) {
+		default:
+		case 0:
+			*s = sn;
+			*c = cs;
+			break;
+		case 1:
+			*s = cs;
+			*c = _sllneg(sn);
+			break;
+		case 2:
+			*s = _sllneg(sn);
+			*c = _sllneg(cs);
+			break;
+		case 3:
+			*s = _sllneg(cs);
+			*c = sn;
+			break;
+	}
+}
+
+/*
+ * Calculate sin a and cos a of a binary angle
+ *
+ * Description
+ *
+ *	The top 2 bits of a are the quadrant, the next 6 bits index a table of
+ *	sin k * pi / 128 over the quarter turn, and the low 24 bits are the
+ *	remainder d, where 0 <= d < pi / 128.  Then:
+ *
+ *	sin (u + d) = sin u * cos d + cos u * sin d
+ *	cos (u + d) = cos u * cos d - sin u * sin d
+ *
+ *	(pi / 128)^5 / 5! < 2^-32, so the series for sin d and cos d are short:
+ *	sin d = d - d^3 / 3!
+ *	cos d = 1 - d^2 / 2! + d^4 / 4!
+ *
+ *	cos k * pi / 128 = sin (64 - k) * pi / 128, so one table serves both,
+ *	and there is no argument reduction at all.  This is several times
+ *	cheaper than the two series used by sllsincos().
+ */
+
+static const sll _sllsin_k128[65] = {
+	0x0000000000000000LL,	// sin 0 * pi / 128
+	0x000000000648557eLL,	// sin 1 * pi / 128
+	0x000000000c8fb2f9LL,	// sin 2 * pi / 128
+	0x0000000012d52093LL,	// sin 3 * pi / 128
+	0x000000001917a6bcLL,	// sin 4 * pi / 128
+	0x000000001f564e57LL,	// sin 5 * pi / 128
+	0x00000000259020ddLL,	// sin 6 * pi / 128
+	0x000000002bc42889LL,	// sin 7 * pi / 128
+	0x0000000031f17079LL,	// sin 8 * pi / 128
+	0x00000000381704d5LL,	// sin 9 * pi / 128
+	0x000000003e33f2f6LL,	// sin 10 * pi / 128
+	0x000000004447498bLL,	// sin 11 * pi / 128
+	0x000000004a5018bbLL,	// sin 12 * pi / 128
+	0x00000000504d7250LL,	// sin 13 * pi / 128
+	0x00000000563e69d7LL,	// sin 14 * pi / 128
+	0x000000005c2214c4LL,	// sin 15 * pi / 128
+	0x0000000061f78a9bLL,	// sin 16 * pi / 128
+	0x0000000067bde50fLL,	// sin 17 * pi / 128
+	0x000000006d744028LL,	// sin 18 * pi / 128
+	0x000000007319ba65LL,	// sin 19 * pi / 128
+	0x0000000078ad74e0LL,	// sin 20 * pi / 128
+	0x000000007e2e9370LL,	// sin 21 * pi / 128
+	0x00000000839c3cc9LL,	// sin 22 * pi / 128
+	0x0000000088f59aa1LL,	// sin 23 * pi / 128
+	0x000000008e39d9cdLL,	// sin 24 * pi / 128
+	0x0000000093682a67LL,	// sin 25 * pi / 128
+	0x00000000987fbfe7LL,	// sin 26 * pi / 128
+	0x000000009d7fd149LL,	// sin 27 * pi / 128
+	0x00000000a2679928LL,	// sin 28 * pi / 128
+	0x00000000a73655dfLL,	// sin 29 * pi / 128
+	0x00000000abeb49a4LL,	// sin 30 * pi / 128
+	0x00000000b085baa9LL,	// sin 31 * pi / 128
+	0x00000000b504f334LL,	// sin 32 * pi / 128
+	0x00000000b96841bfLL,	// sin 33 * pi / 128
+	0x00000000bdaef913LL,	// sin 34 * pi / 128
+	0x00000000c1d87060LL,	// sin 35 * pi / 128
+	0x00000000c5e40359LL,	// sin 36 * pi / 128
+	0x00000000c9d1124dLL,	// sin 37 * pi / 128
+	0x00000000cd9f0240LL,	// sin 38 * pi / 128
+	0x00000000d14d3d02LL,	// sin 39 * pi / 128
+	0x00000000d4db3148LL,	// sin 40 * pi / 128
+	0x00000000d84852c1LL,	// sin 41 * pi / 128
+	0x00000000db941a29LL,	// sin 42 * pi / 128
+	0x00000000debe0563LL,	// sin 43 * pi / 128
+	0x00000000e1c5978cLL,	// sin 44 * pi / 128
+	0x00000000e4aa590aLL,	// sin 45 * pi / 128
+	0x00000000e76bd7a2LL,	// sin 46 * pi / 128
+	0x00000000ea09a68aLL,	// sin 47 * pi / 128
+	0x00000000ec835e7aLL,	// sin 48 * pi / 128
+	0x00000000eed89db6LL,	// sin 49 * pi / 128
+	0x00000000f1090828LL,	// sin 50 * pi / 128
+	0x00000000f3144762LL,	// sin 51 * pi / 128
+	0x00000000f4fa0ab6LL,	// sin 52 * pi / 128
+	0x00000000f6ba073bLL,	// sin 53 * pi / 128
+	0x00000000f853f7ddLL,	// sin 54 * pi / 128
+	0x00000000f9c79d63LL,	// sin 55 * pi / 128
+	0x00000000fb14be80LL,	// sin 56 * pi / 128
+	0x00000000fc3b27d4LL,	// sin 57 * pi / 128
+	0x00000000fd3aabf8LL,	// sin 58 * pi / 128
+	0x00000000fe132387LL,	// sin 59 * pi / 128
+	0x00000000fec46d1fLL,	// sin 60 * pi / 128
+	0x00000000ff4e6d68LL,	// sin 61 * pi / 128
+	0x00000000ffb10f1cLL,	// sin 62 * pi / 128
+	0x00000000ffec4304LL,	// sin 63 * pi / 128
+	0x0000000100000000LL	// sin 64 * pi / 128
+};
+
+void sllsincosbam(unsigned a, sll *s, sll *c)
+{
+	int k;
+	sll d;
+	sll d2;
+	sll sd;
+	sll cd;
+	sll su;
+	sll cu;
+	sll sn;
+	sll cs;
+
+	k = (a >> 24) & 0x3f;
+	d = bam2sll(a & 0x00ffffff);
+	d2 = sllmul(d, d);
+
+	sd = _sllsub(d, sllmul(d, sllmul(d2, CONST_1_6)));
+	cd = _sllsub(CONST_1, sllmul(d2, _sllsub(CONST_1_2,
+		sllmul(d2, CONST_1_24))));
+
+	su = _sllsin_k128[k];
+	cu = _sllsin_k128[64 - k];
+
+	sn = _slladd(sllmul(su, cd), sllmul(cu, sd));
+	cs = _sllsub(sllmul(cu, cd), sllmul(su, sd));
+
+	/* Locate the quadrant */
+	switch (a >> 30) {
+		default:
+		case 0:
+			*s = sn;
+			*c = cs;
+			break;
+		case 1:
+			*s = cs;
+			*c = _sllneg(sn);
+			break;
+		case 2:
+			*s = _sllneg(sn);
+			*c = _sllneg(cs);
+			break;
+		case 3:
+			*s = _sllneg(cs);
+			*c = sn;
+			break;
+	}
+}
+
 /*
  *
  * Calculate asin x, where |x| <= 1
@@ -586,9 +857,9 @@ sll sllatan(sll x)
 	sll retval;
 
 
-	if (x < CONST_1) {
+	if (x < _sllneg(CONST_1)) {
 
-		/* Left:  if (x < -1) then atan x = pi / 2 + atan 1 / x */
+		/* Left:  if (x < -1) then atan x = -pi / 2 - atan 1 / x */
 		side = -1;
 		x = sllinv(x);
 
@@ -621,8 +892,8 @@ sll sllatan(sll x)
 
 	if (side == -1) {
 
-		/* Left:  if (x < -1) then atan x = pi / 2 + atan 1 / x */
-		retval = _slladd(CONST_PI_2, retval);
+		/* Left:  if (x < -1) then atan x = -pi / 2 - atan 1 / x */
+		retval = _sllsub(_sllneg(CONST_PI_2), retval);
 
 	} else if (side == 1) {
 
@@ -633,6 +904,127 @@ sll sllatan(sll x)
 	return retval;
 }
 
+/*
+ * Calculate x / y for any non-zero y, keeping full precision
+ *
+ * Description
+ *
+ *	The inverse of a large y has few significant bits, so slldiv() loses
+ *	precision when y is large.  Instead scale y by 2^-k so that
+ *	1 <= y * 2^-k < 2, where the inverse is accurate to the last bit:
+ *
+ *	x / y = (x / (y * 2^-k)) * 2^-k
+ *
+ *	For small y, x is scaled up with y while that is exact.  Once x
+ *	reaches 2^62, x / y is at least 2^30, and the rest of the scaling is
+ *	applied to the result, saturating.  y = 0 saturates by the sign of x.
+ */
+
+static sll _sllratio(sll x, sll y)
+{
+	int k;
+	int sgn;
+	sll retval;
+
+	if (y == CONST_0)
+		return (x < CONST_0) ? CONST_MIN: CONST_MAX;
+
+	/* -CONST_MIN isn't representable, and CONST_MAX is as good */
+	if ((sgn = y < CONST_0))
+		y = (y == CONST_MIN) ? CONST_MAX: _sllneg(y);
+
+	for (k = 0; y >= CONST_2; k++)
+		y = slldiv2(y);
+	while (y < CONST_1) {
+		if (x >= ((sll) 1 << 62) || x < -((sll) 1 << 62))
+			k--;
+		else
+			x = sllmul2(x);
+		y = sllmul2(y);
+	}
+
+	retval = sllmul(x, sllinv(y));
+	if (k >= 0)
+		retval = slldiv2n(retval, k);
+	for (; k < 0; k++)
+		retval = slladdsat(retval, retval);
+
+	if (sgn)
+		retval = (retval == CONST_MIN) ? CONST_MAX: _sllneg(retval);
+
+	return retval;
+}
+
+/*
+ * Calculate atan y / x, by quadrant
+ *
+ * Description
+ *
+ *	Fold into the first octant so that 0 <= t = min / max <= 1, then pick
+ *	the nearest table point c = k / 8 and apply the standard identity:
+ *	atan t = atan c + atan ((t - c) / (1 + t * c))
+ *
+ *	The remainder u is at most 1/16 in magnitude, and (1/16)^11 / 11 is
+ *	below 2^-32, so the series needs only five terms:
+ *	atan u = u - u^3 / 3 + u^5 / 5 - u^7 / 7 + u^9 / 9
+ *
+ *	This costs two divisions and no trigonometric functions.
+ */
+
+static const sll _sllatan_k8[9] = {
+	0x0000000000000000LL,	// atan 0 / 8
+	0x000000001fd5ba9aLL,	// atan 1 / 8
+	0x000000003eb6ebf2LL,	// atan 2 / 8
+	0x000000005bd86507LL,	// atan 3 / 8
+	0x0000000076b19c15LL,	// atan 4 / 8
+	0x000000008f005d5eLL,	// atan 5 / 8
+	0x00000000a4bc7d19LL,	// atan 6 / 8
+	0x00000000b8053e2bLL,	// atan 7 / 8
+	0x00000000c90fdaa2LL	// atan 8 / 8
+};
+
+sll sllatan2(sll y, sll x)
+{
+	int k;
+	sll ax;
+	sll ay;
+	sll c;
+	sll t;
+	sll u;
+	sll u2;
+	sll retval;
+
+	ax = (x < CONST_0) ? _sllneg(x): x;
+	ay = (y < CONST_0) ? _sllneg(y): y;
+
+	if (ax == CONST_0 && ay == CONST_0)
+		return CONST_0;
+
+	/* First octant:  0 <= t <= 1 */
+	t = (ay <= ax) ? _sllratio(ay, ax): _sllratio(ax, ay);
+
+	/* Nearest table point */
+	k = (int) (_slladd(t, 0x0000000010000000LL) >> 29);
+	c = _int2sll(k) >> 3;
+	u = slldiv(_sllsub(t, c), _slladd(CONST_1, sllmul(t, c)));
+
+	/* Short series */
+	u2 = sllmul(u, u);
+	retval = _sllsub(CONST_1_7, sllmul(u2, CONST_1_9));
+	retval = _sllsub(CONST_1_5, sllmul(u2, retval));
+	retval = _sllsub(CONST_1_3, sllmul(u2, retval));
+	retval = _sllsub(CONST_1, sllmul(u2, retval));
+	retval = _slladd(_sllatan_k8[k], sllmul(u, retval));
+
+	/* Unfold the octant, then the quadrant */
+	if (ay > ax)
+		retval = _sllsub(CONST_PI_2, retval);
+	if (x < CONST_0)
+		retval = _sllsub(CONST_PI, retval);
+
+	return ((y < CONST_0) ? _sllneg(retval): retval);
+}
+
 /*
  * Calculate e^x where -0.5 <= x <= 0.5
  *
@@ -663,219 +1055,5795 @@ sll _sllexp(sll x)
 }
 
 /*
- * Calculate e^x for any value of x
+ * Multiply x by a constant k scaled by 2^s, rounding, where 0 < s < 64
  */
 
-sll sllexp(sll x)
+static sll _sllmulk(sll x, sll k, int s)
 {
-	int i;
-	sll e;
-	sll retval;
+	sll hi;
+	ull lo;
 
-	e = CONST_E;
+	_sllmul128(x, k, &hi, &lo);
 
-	/* -0.5 <= x <= 0.5  */
-	i = _sll2int(_slladd(x, CONST_1_2));
-	retval = _sllexp(_sllsub(x, _int2sll(i)));
-
-	/* i >= 0 */
-	if (i < 0) {
-		i = -i;
-		e = CONST_1_E;
-	}
+	return (sll) (((ull) hi << (64 - s)) | (lo >> s)) +
+		(sll) ((lo >> (s - 1)) & 1);
+}
 
-	/* Scale the result */
-	for (; i; i >>= 1) {
-		if (i & 1)
-			retval = sllmul(retval, e);
-		e = sllmul(e, e);
-	}
+/*
+ * ln 2 * 2^62, log10(2) * 2^62 and ln 10 * 2^60, for _sllmulk()
+ */
 
-	return retval;
-}
+#define _SLL_LN2_62	0x2c5c85fdf473de6bLL
+#define _SLL_LOG10_2_62	0x134413509f79fef3LL
+#define _SLL_LN10_60	0x24d763776aaa2b06LL
 
 /*
- * Calculate natural logarithm using Netwton-Raphson method
+ * Scale by 2^k, saturating
  */
 
-sll slllog(sll x)
+static sll _sllscale2(sll x, int k)
 {
-	sll x1;
-	sll ln;
+	if (k <= -64)
+		return CONST_0;
+	if (k < 0)
+		return (x + ((sll) 1 << (-k - 1))) >> -k;
+	if (k >= 63 || x > (CONST_MAX >> k))
+		return CONST_MAX;
 
-	ln = 0;
+	return x << k;
+}
 
-	/* Scale: e^(-1/2) <= x <= e^(1/2) */
-	while (x < CONST_1_SQRTE) {
-		ln = _sllsub(ln, CONST_1);
-		x = sllmul(x, CONST_E);
-	}
-	while (x > CONST_SQRTE) {
-		ln = _slladd(ln, CONST_1);
-		x = sllmul(x, CONST_1_E);
-	}
+/*
+ * Calculate e^x for any value of x
+ *
+ * Description
+ *
+ *	e^x = 2^k * e^r
+ *
+ *	with k the nearest integer to x / ln 2, and r = x - k * ln 2, so
+ *	|r| <= ln 2 / 2.  k * ln 2 is taken with a 62 bit ln 2, so r is good
+ *	to the last bit, and the scaling is a shift.  Saturates when e^x is
+ *	too large.
+ */
 
-	/* First iteration */
-	x1 = sllmul(_sllsub(x, CONST_1), slldiv2(_sllsub(x, CONST_3)));
-	ln = _sllsub(ln, x1);
-	x = sllmul(x, _sllexp(x1));
+sll sllexp(sll x)
+{
+	int k;
 
-	/* Second iteration */
-	x1 = sllmul(_sllsub(x, CONST_1), slldiv2(_sllsub(x, CONST_3)));
-	ln = _sllsub(ln, x1);
-	x = sllmul(x, _sllexp(x1));
+	/* e^22 > 2^31, e^-23 < 2^-33 */
+	if (x > _int2sll(22))
+		return CONST_MAX;
+	if (x < _sllneg(_int2sll(23)))
+		return CONST_0;
 
-	/* Third iteration */
-	x1 = sllmul(_sllsub(x, CONST_1), slldiv2(_sllsub(x, CONST_3)));
-	ln = _sllsub(ln, x1);
+	k = _sll2int(_slladd(sllmul(x, CONST_LOG2_E), CONST_1_2));
 
-	return ln;
+	return _sllscale2(_sllexp(_sllsub(x, _sllmulk(k, _SLL_LN2_62, 30))),
+		k);
 }
 
 /*
- * Calculate the inverse for non-zero values
+ * Calculate 2^x
+ *
+ * Description
+ *
+ *	2^x = 2^k * e^(f * ln 2)
+ *
+ *	with k the nearest integer to x and f = x - k.
  */
 
-sll sllinv(sll x)
+sll sllexp2(sll x)
 {
-	int sgn;
-	sll u;
-	ull s;
+	int k;
 
-	/* Use positive numbers, or the approximation won't work */
-	if (x < CONST_0) {
-		x = _sllneg(x);
-		sgn = 1;
-	} else {
-		sgn = 0;
-	}
+	if (x >= _int2sll(31))
+		return CONST_MAX;
+	if (x < _sllneg(_int2sll(33)))
+		return CONST_0;
 
-	/* Starting-point (gets shifted right to become positive) */
-	s = -1;
+	k = _sll2int(_slladd(x, CONST_1_2));
 
-	/* An approximation - must be larger than the actual value */
-	for (u = x; u; u = ((ull) u) >> 1)
-		s >>= 1;
+	return _sllscale2(_sllexp(_sllmulk(_sllsub(x, _int2sll(k)),
+		_SLL_LN2_62, 62)), k);
+}
 
-	/* Newton's Method */
-	u = sllmul(s, _sllsub(CONST_2, sllmul(x, s)));
-	u = sllmul(u, _sllsub(CONST_2, sllmul(x, u)));
-	u = sllmul(u, _sllsub(CONST_2, sllmul(x, u)));
-	u = sllmul(u, _sllsub(CONST_2, sllmul(x, u)));
-	u = sllmul(u, _sllsub(CONST_2, sllmul(x, u)));
-	u = sllmul(u, _sllsub(CONST_2, sllmul(x, u)));
+/*
+ * Calculate 10^x
+ *
+ * Description
+ *
+ *	Integral x is left to sllpowi(), which is exact for x >= 0.  Otherwise
+ *	10^x = e^(x * ln 10), with a 60 bit ln 10.
+ */
 
-	return ((sgn) ? _sllneg(u): u);
+sll sllexp10(sll x)
+{
+	if (x >= _int2sll(10))
+		return CONST_MAX;
+	if (x < _sllneg(_int2sll(10)))
+		return CONST_0;
+
+	if (sllfrac(x) == CONST_0)
+		return sllpowi(_int2sll(10), _sll2int(x));
+
+	return sllexp(_sllmulk(x, _SLL_LN10_60, 60));
 }
 
 /*
- * Calculate x^y
+ * 1 / k!, for the series of e^x - 1
+ */
+
+static const sll _sllexpm1_k[11] = {
+	0x0000000100000000LL, 0x0000000080000000LL, 0x000000002aaaaaabLL,
+	0x000000000aaaaaabLL, 0x0000000002222222LL, 0x00000000005b05b0LL,
+	0x00000000000d00d0LL, 0x000000000001a01aLL, 0x0000000000002e3cLL,
+	0x00000000000004a0LL, 0x000000000000006cLL
+};
+
+/*
+ * Calculate e^x - 1
  *
  * Description
  *
- *	The standard identity:
- *	ln x^y = y * log x
+ *	For |x| < 1 / 2,
  *
- *	Raising e to the power of either sides:
- *	e^(ln x^y) = e^(y * log x)
+ *	e^x - 1 = x + x^2 * (1 / 2! + x / 3! + ... + x^(n - 2) / n!)
  *
- *	Which simplifies to:
- *	x^y = e^(y * ln x)
+ *	with |x| < 2^-b and n + 1 >= 33 / b, so the series is as short as
+ *	the size of x allows, and x + x^2 / 2 is all that is left below
+ *	2^-16.  x itself is never rounded.  Elsewhere e^x - 1 loses nothing,
+ *	and saturates as sllexp() does.
  */
 
-sll sllpow(sll x, sll y)
+sll sllexpm1(sll x)
 {
-	if (y == CONST_0)
-		return CONST_1;
+	int b, n;
+	sll retval;
 
-	return sllexp(sllmul(y, slllog(x)));
+	if (x >= CONST_1_2 || x <= _sllneg(CONST_1_2)) {
+		retval = sllexp(x);
+		return (retval == CONST_MAX) ? CONST_MAX:
+			_sllsub(retval, CONST_1);
+	}
+
+	b = 32 - _sllbits((ull) _sllabs(x));
+	n = (33 + b - 1) / b - 1;
+	if (n < 2)
+		return x;
+	if (n > 11)
+		n = 11;
+
+	for (retval = _sllexpm1_k[n - 1]; n > 2; n--)
+		retval = _slladd(_sllexpm1_k[n - 2], sllmul(x, retval));
+
+	return _slladd(x, sllmul(x, sllmul(x, retval)));
 }
 
 /*
- * Calculate the square-root
+ * 1 / (2 * k + 3), for the series of atanh
+ */
+
+static const sll _sllatanh_k[9] = {
+	0x0000000055555555LL, 0x0000000033333333LL, 0x0000000024924925LL,
+	0x000000001c71c71cLL, 0x000000001745d174LL, 0x0000000013b13b14LL,
+	0x0000000011111111LL, 0x000000000f0f0f0fLL, 0x000000000d79435eLL
+};
+
+/*
+ * Split x > 0 into m * 2^e, returning ln m * 2^62
  *
  * Description
  *
- *	Consider a parabola centered on the y-axis:
- * 	y = a * x^2 + b
- *
- *	Has zeros (y = 0) located at:
- *	a * x^2 + b = 0
- *	a * x^2 = -b
- *	x^2 = -b / a
- *	x = +- (-b / a)^(1 / 2)
- *
- *	Letting a = 1 and b = -X results in:
- *	y = x^2 - X
- *	x = +- X^(1 / 2)
- *
- *	Which is a convenient result, since we want to find the square root of X,
- *	and we can * use Newton's Method to find the zeros of any f(x):
- *	xn = x - f(x) / f'(x)
+ *	e comes from the leading bit, and is raised by 1 if the mantissa is
+ *	over 2^(1 / 2), so 2^(-1 / 2) <= m < 2^(1 / 2).  Then
  *
- *	Applying Newton's Method to our parabola:
- *	f(x) = x^2 - X
- *	xn = x - (x^2 - X) / (2 * x)
- *	xn = x - (x - X / x) / 2
+ *	ln m = 2 * atanh(z) = 2 * (z + z^3 / 3 + z^5 / 5 + ...)
  *
- *	To make this converge quickly, we scale X so that:
- *	X = 4^N * z
+ *	with z = (m - 1) / (m + 1), where |z| < 0.172, so terms to z^11 are
+ *	enough.  z is the same ratio of x - 2^e and x + 2^e, which are exact,
+ *	and halved when 2^e is near the top of the range.  The last multiply
+ *	is exact, but z has only 32 fraction bits, so the result is good to a
+ *	few 2^-32, not to the 62 bits it carries.
+ */
+
+static sll _slllogm(sll x, int *e)
+{
+	int k;
+	sll p;
+	sll z, z2;
+	sll retval;
+	sllacc a;
+
+	k = _sllbits((ull) x) - 1;
+	if ((k >= 32) ? (x >> (k - 32)) >= CONST_SQRT2:
+			(x << (32 - k)) >= CONST_SQRT2)
+		k++;
+	*e = k - 32;
+
+	if (k >= 62) {
+		p = (sll) 1 << (k - 1);
+		x >>= 1;
+	} else {
+		p = (sll) 1 << k;
+	}
+	z = _sllratio(_sllsub(x, p), _slladd(x, p));
+	z2 = sllmul(z, z);
+
+	for (retval = CONST_0, k = 5; k > 0; k--)
+		retval = sllmul(z2, _slladd(retval, _sllatanh_k[k - 1]));
+
+	/* 2 * (z + z * retval) in 64.64, to 2^-62 */
+	sllacczero(&a);
+	sllaccadd(&a, z);
+	sllaccmac(&a, z, retval);
+
+	return _sllaccshift(&a, 1);
+}
+
+/*
+ * Multiply t by k, both scaled by 2^62, to sll, rounding
+ */
+
+static sll _sllmul62(sll t, sll k)
+{
+	sll hi;
+	ull lo;
+
+	/* The product is scaled by 2^124, hi by 2^60 */
+	_sllmul128(t, k, &hi, &lo);
+
+	return (hi + ((sll) 1 << 27)) >> 28;
+}
+
+/*
+ * log2(e) * 2^62 and log10(e) * 2^62, for _sllmul62()
+ */
+
+#define _SLL_LOG2_E_62	0x5c551d94ae0bf85eLL
+#define _SLL_LOG10_E_62	0x1bcb7b1526e50e33LL
+
+/*
+ * Calculate natural logarithm
+ *
+ * Description
+ *
+ *	ln x = e * ln 2 + ln m
+ *
+ *	with x = m * 2^e from _slllogm(), and a 62 bit ln 2, rounded once.
+ *	Returns CONST_MIN for x <= 0.
+ */
+
+sll slllog(sll x)
+{
+	int e;
+	sll t;
+	sllacc a;
+
+	if (x <= CONST_0)
+		return CONST_MIN;
+
+	t = _slllogm(x, &e);
+
+	/* e * ln 2 + ln m, scaled by 2^62 */
+	_sllmul128(e, _SLL_LN2_62, &a.hi, &a.lo);
+	_sllaccadd128(&a, t >> 63, (ull) t);
+
+	return _sllaccshift(&a, 30) + (sll) ((a.lo >> 29) & 1);
+}
+
+/*
+ * Calculate base 2 logarithm
+ *
+ * Description
+ *
+ *	log2 x = e + ln m * log2(e)
+ */
+
+sll slllog2(sll x)
+{
+	int e;
+	sll t;
+
+	if (x <= CONST_0)
+		return CONST_MIN;
+
+	t = _slllogm(x, &e);
+
+	return _slladd(_int2sll(e), _sllmul62(t, _SLL_LOG2_E_62));
+}
+
+/*
+ * Calculate base 10 logarithm
+ *
+ * Description
+ *
+ *	log10 x = e * log10(2) + ln m * log10(e)
+ */
+
+sll slllog10(sll x)
+{
+	int e;
+	sll t;
+
+	if (x <= CONST_0)
+		return CONST_MIN;
+
+	t = _slllogm(x, &e);
+
+	return _slladd(_sllmulk(e, _SLL_LOG10_2_62, 30), _sllmul62(t,
+		_SLL_LOG10_E_62));
+}
+
+/*
+ * 1 / k, for the series of ln(1 + x)
+ */
+
+static const sll _slllog1p_k[8] = {
+	CONST_1, CONST_1_2, CONST_1_3, CONST_1_4, CONST_1_5, CONST_1_6,
+	CONST_1_7, CONST_1_8
+};
+
+/*
+ * Calculate ln(1 + x)
+ *
+ * Description
+ *
+ *	For |x| < 1 / 2,
+ *
+ *	ln(1 + x) = 2 * atanh(z) = x - x * z + 2 * z * (z^2 / 3 + z^4 / 5 + ...)
+ *
+ *	with z = x / (2 + x), as 2 * z = x - x * z.  x is exact and x * z
+ *	small, so the error of the ratio hardly shows, and the sum is
+ *	rounded once.  With |z| < 2^-b, the series stops once z^(2 * n + 3)
+ *	is under 2^-34.  Below 2^-4 the plain series
+ *
+ *	ln(1 + x) = x - x^2 / 2 + x^3 / 3 - ... + (-1)^(n + 1) * x^n / n
+ *
+ *	needs no ratio, and with |x| < 2^-b, n + 1 >= 33 / b terms are
+ *	enough.  Elsewhere 1 + x is exact and goes to slllog().  Returns
+ *	CONST_MIN for x <= -1.
+ */
+
+sll slllog1p(sll x)
+{
+	int b, n;
+	sll z, z2;
+	sll retval;
+	sllacc a;
+
+	if (x <= _sllneg(CONST_1))
+		return CONST_MIN;
+	if (x >= CONST_1_2 || x <= _sllneg(CONST_1_2))
+		return slllog((x > _sllsub(CONST_MAX, CONST_1)) ? x:
+			_slladd(CONST_1, x));
+
+	b = 32 - _sllbits((ull) _sllabs(x));
+	if (b >= 4) {
+		n = (33 + b - 1) / b - 1;
+		if (n < 2)
+			return x;
+
+		for (retval = _slllog1p_k[n - 1]; n > 2; n--)
+			retval = _sllsub(_slllog1p_k[n - 2], sllmul(x, retval));
+
+		return _sllsub(x, sllmul(x, sllmul(x, retval)));
+	}
+
+	z = _sllratio(x, _slladd(CONST_2, x));
+	z2 = sllmul(z, z);
+
+	b = 32 - _sllbits((ull) _sllabs(z));
+	n = (b > 0) ? ((34 + b - 1) / b - 2) / 2: 9;
+	if (n > 9)
+		n = 9;
+
+	for (retval = CONST_0; n > 0; n--)
+		retval = sllmul(z2, _slladd(retval, _sllatanh_k[n - 1]));
+
+	sllacczero(&a);
+	sllaccadd(&a, x);
+	sllaccmac(&a, _sllneg(x), z);
+	sllaccmac(&a, sllmul2(z), retval);
+
+	return _sllaccshift(&a, 32) + (sll) ((a.lo >> 31) & 1);
+}
+
+/*
+ * Logarithms and exponentials of arrays
+ */
+
+void sllexp2v(sll *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = sllexp2(x[i]);
+}
+
+void sllexp10v(sll *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = sllexp10(x[i]);
+}
+
+void slllog2v(sll *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = slllog2(x[i]);
+}
+
+void slllog10v(sll *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = slllog10(x[i]);
+}
+
+void sllexpm1v(sll *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = sllexpm1(x[i]);
+}
+
+void slllog1pv(sll *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = slllog1p(x[i]);
+}
+
+/*
+ * Calculate the inverse for non-zero values
+ */
+
+sll sllinv(sll x)
+{
+	int sgn;
+	sll u;
+	ull s;
+
+	/* Use positive numbers, or the approximation won't work */
+	if (x < CONST_0) {
+		x = _sllneg(x);
+		sgn = 1;
+	} else {
+		sgn = 0;
+	}
+
+	/* Starting-point (gets shifted right to become positive) */
+	s = -1;
+
+	/* An approximation - must be larger than the actual value */
+	for (u = x; u; u = ((ull) u) >> 1)
+		s >>= 1;
+
+	/* Newton's Method */
+	u = sllmul(s, _sllsub(CONST_2, sllmul(x, s)));
+	u = sllmul(u, _sllsub(CONST_2, sllmul(x, u)));
+	u = sllmul(u, _sllsub(CONST_2, sllmul(x, u)));
+	u = sllmul(u, _sllsub(CONST_2, sllmul(x, u)));
+	u = sllmul(u, _sllsub(CONST_2, sllmul(x, u)));
+	u = sllmul(u, _sllsub(CONST_2, sllmul(x, u)));
+
+	return ((sgn) ? _sllneg(u): u);
+}
+
+/*
+ * Whether an exponent y is left to sllpowi()
+ *
+ * Description
+ *
+ *	y integral and above -2^31.  No sll reaches 2^31, so there is no
+ *	upper bound to check.
+ */
+
+static int _sllpowint(sll y)
+{
+	return sllfrac(y) == CONST_0 && y >= _sllneg(_int2sll(0x7fffffff));
+}
+
+/*
+ * Calculate x^y
+ *
+ * Description
+ *
+ *	The standard identity:
+ *	ln x^y = y * log x
+ *
+ *	Raising e to the power of either sides:
+ *	e^(ln x^y) = e^(y * log x)
+ *
+ *	Which simplifies to:
+ *	x^y = e^(y * ln x)
+ *
+ *	Integral y is left to sllpowi(), which is faster, more precise, and
+ *	right for x < 0.  Otherwise x^y isn't real for x < 0, and 0 is
+ *	returned.  0^y is 0 for y > 0 and saturates for y < 0, as sllpowi()
+ *	does.
+ */
+
+sll sllpow(sll x, sll y)
+{
+	if (y == CONST_0)
+		return CONST_1;
+
+	/* Integral y, for which x may be negative */
+	if (_sllpowint(y))
+		return sllpowi(x, _sll2int(y));
+
+	if (x == CONST_0)
+		return (y > CONST_0) ? CONST_0: CONST_MAX;
+
+	/* Not real for x < 0 */
+	if (x < CONST_0)
+		return CONST_0;
+
+	return sllexp(sllmul(y, slllog(x)));
+}
+
+/*
+ * Calculate x^n for integer n
+ *
+ * Description
+ *
+ *	Square and multiply:  x is squared for each bit of |n|, and multiplies
+ *	the result where the bit is set, so it takes no more than 2 * log2 |n|
+ *	multiplies, saturating on overflow.
+ *
+ *	For n < 0, x^n = 1 / x^|n| when |x| >= 1, which has full relative
+ *	precision, and (1 / x)^|n| otherwise, where 1 / x does.  1 / x
+ *	saturates for |x| of 2^-31 or less, where it's 2^31 or more.
+ */
+
+sll sllpowi(sll x, int n)
+{
+	int inv;
+	unsigned u;
+	sll retval;
+
+	if (n == 0)
+		return CONST_1;
+	if (x == CONST_0)
+		return (n > 0) ? CONST_0: CONST_MAX;
+
+	u = (n < 0) ? 0 - (unsigned) n: (unsigned) n;
+	inv = n < 0;
+	if (inv && _sllabs(x) < CONST_1) {
+		/* 1 / x is at least 2^31 */
+		if (x >= -2 && x <= 2)
+			x = (x > CONST_0) ? CONST_MAX: CONST_MIN;
+		else
+			x = _sllratio(CONST_1, x);
+		inv = 0;
+	}
+
+	for (retval = CONST_1; ; ) {
+		if (u & 1)
+			retval = sllmulsat(retval, x);
+		if ((u >>= 1) == 0)
+			break;
+		x = sllmulsat(x, x);
+	}
+
+	if (inv) {
+		/* Saturated, so 1 / x^|n| is under 2^-31 */
+		if (retval == CONST_MAX || retval == CONST_MIN)
+			return CONST_0;
+		retval = _sllratio(CONST_1, retval);
+	}
+
+	return retval;
+}
+
+/*
+ * Prepare powers of a base x > 0
+ */
+
+void sllpowxinit(sllpowx *p, sll x)
+{
+	p->x = x;
+	p->ln = slllog(x);
+}
+
+/*
+ * x^y of a prepared base
+ */
+
+sll sllpowxeval(const sllpowx *p, sll y)
+{
+	if (_sllpowint(y))
+		return sllpowi(p->x, _sll2int(y));
+
+	return sllexp(sllmul(y, p->ln));
+}
+
+/*
+ * x^y of a prepared base for an array of y
+ */
+
+void sllpowxv(const sllpowx *p, sll *r, const sll *y, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		r[i] = sllpowxeval(p, y[i]);
+}
+
+/*
+ * Methods of sllpowy
+ */
+
+#define _SLLPOW_LOG	0	// e^(y * ln x)
+#define _SLLPOW_INT	1	// sllpowi()
+#define _SLLPOW_SQRT	2	// x^(1 / 2)
+#define _SLLPOW_RSQRT	3	// x^(-1 / 2)
+#define _SLLPOW_CBRT	4	// x^(1 / 3)
+
+/*
+ * Prepare powers with an exponent y
+ */
+
+void sllpowyinit(sllpowy *p, sll y)
+{
+	p->y = y;
+	p->n = 0;
+	p->lut = 0;
+	p->bits = 0;
+
+	if (_sllpowint(y)) {
+		p->kind = _SLLPOW_INT;
+		p->n = _sll2int(y);
+	} else if (y == CONST_1_2) {
+		p->kind = _SLLPOW_SQRT;
+	} else if (y == _sllneg(CONST_1_2)) {
+		p->kind = _SLLPOW_RSQRT;
+	} else if (y == CONST_1_3) {
+		p->kind = _SLLPOW_CBRT;
+	} else {
+		p->kind = _SLLPOW_LOG;
+	}
+}
+
+/*
+ * x^y with a prepared exponent, without the table
+ */
+
+static sll _sllpowy(const sllpowy *p, sll x)
+{
+	switch (p->kind) {
+	case _SLLPOW_INT:
+		return sllpowi(x, p->n);
+	case _SLLPOW_SQRT:
+		return sllsqrt(x);
+	case _SLLPOW_RSQRT:
+		return sllrsqrt(x);
+	case _SLLPOW_CBRT:
+		return sllcbrt(x);
+	}
+
+	/* Not real for x < 0 */
+	if (x < CONST_0)
+		return CONST_0;
+	if (x == CONST_0)
+		return (p->y > CONST_0) ? CONST_0: CONST_MAX;
+
+	return sllexp(sllmul(p->y, slllog(x)));
+}
+
+/*
+ * Fill and use a table for 0 <= x < 1
+ *
+ * Description
+ *
+ *	For y < 0, x^y is unbounded at 0 and saturates there, so that the
+ *	first interval would interpolate from 2^31.  The table is left unused.
+ */
+
+void sllpowylut(sllpowy *p, sll *lut, int bits)
+{
+	int i;
+
+	if (p->y < CONST_0)
+		return;
+
+	for (i = 0; i <= 1 << bits; i++)
+		lut[i] = _sllpowy(p, _int2sll(i) >> bits);
+
+	p->lut = lut;
+	p->bits = bits;
+}
+
+/*
+ * x^y with a prepared exponent
+ *
+ * Description
+ *
+ *	In the table, the top bits of the fraction of x are the index, and
+ *	the rest the position between entries.
+ */
+
+sll sllpowyeval(const sllpowy *p, sll x)
+{
+	int i;
+	sll f;
+
+	if (!p->lut || x < CONST_0 || x >= CONST_1)
+		return _sllpowy(p, x);
+
+	i = (int) (x >> (32 - p->bits));
+	f = (x << p->bits) & 0xffffffffLL;
+
+	return _slladd(p->lut[i], sllmul(f, _sllsub(p->lut[i + 1],
+		p->lut[i])));
+}
+
+/*
+ * x^y with a prepared exponent for an array of x
+ */
+
+void sllpowyv(const sllpowy *p, sll *r, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		r[i] = sllpowyeval(p, x[i]);
+}
+
+/*
+ * Calculate the square-root
+ *
+ * Description
+ *
+ *	Consider a parabola centered on the y-axis:
+ * 	y = a * x^2 + b
+ *
+ *	Has zeros (y = 0) located at:
+ *	a * x^2 + b = 0
+ *	a * x^2 = -b
+ *	x^2 = -b / a
+ *	x = +- (-b / a)^(1 / 2)
+ *
+ *	Letting a = 1 and b = -X results in:
+ *	y = x^2 - X
+ *	x = +- X^(1 / 2)
+ *
+ *	Which is a convenient result, since we want to find the square root of X,
+ *	and we can * use Newton's Method to find the zeros of any f(x):
+ *	xn = x - f(x) / f'(x)
+ *
+ *	Applying Newton's Method to our parabola:
+ *	f(x) = x^2 - X
+ *	xn = x - (x^2 - X) / (2 * x)
+ *	xn = x - (x - X / x) / 2
+ *
+ *	To make this converge quickly, we scale X so that:
+ *	X = 4^N * z
+ *
+ *	Taking the roots of both sides
+ *	X^(1 / 2) = (4^n * z)^(1 / 2)
+ *	X^(1 / 2) = 2^n * z^(1 / 2)
+ *
+ *	Letting N = 2^n results in:
+ *	x^(1 / 2) = N * z^(1 / 2)
+ *
+ *	We want this to converge to the positive root, so we must start at a point
+ *	0 < start <= x^(1 / 2)
+ * 	or
+ *	x^(1/2) <= start <= infinity
+ *
+ *	Since:
+ *	(1/2)^(1/2) = 0.707
+ *	2^(1/2) = 1.414
+ *
+ *	A good choice is 1 which lies in the middle, and takes 4 iterations to
+ *	converge from either extreme.
+ */
+
+sll sllsqrt(sll x)
+{
+	sll n;
+	sll xn;
+       
+	/* Quick solutions for the simple cases */
+	if (x <= CONST_0 || x == CONST_1)
+		return x;
+
+	/* Start with a scaling factor of 1 */
+	n = CONST_1;
+
+	/* Scale x so that 0.5 <= x < 2 */
+	while (x >= CONST_2) {
+		x = slldiv4(x);
+		n = sllmul2(n);
+	}
+	while (x < CONST_1_2) {
+		x = sllmul4(x);
+		n = slldiv2(n);
+	}
+
+	/* Simple solution if x = 4^n */
+	if (x == CONST_1)
+		return n;
+
+	/* The starting point */
+	xn = CONST_1;
+
+	/* Four iterations will be enough */
+	xn = _sllsub(xn, slldiv2(_sllsub(xn, slldiv(x, xn))));
+	xn = _sllsub(xn, slldiv2(_sllsub(xn, slldiv(x, xn))));
+	xn = _sllsub(xn, slldiv2(_sllsub(xn, slldiv(x, xn))));
+	xn = _sllsub(xn, slldiv2(_sllsub(xn, slldiv(x, xn))));
+
+	/* Scale the result */
+	return sllmul(n, xn);
+}
+
+/*
+ * Calculate 1 / x^(1 / 2) for x > 0, as y * 2^-k
+ *
+ * Description
+ *
+ *	x = m * 4^k with 1 / 2 <= m < 2 is found from the leading bit, so
+ *	y = 1 / m^(1 / 2), which keeps full precision however large or small
+ *	the result.  A quadratic is within 3% of y, and each Newton step
+ *
+ *	y = y * (3 - m * y^2) / 2
+ *
+ *	roughly squares the error, so three give full precision.
+ */
+
+static sll _sllrsqrt(sll x, int *k)
+{
+	int i;
+	sll y;
+
+	/* 2^e <= x < 2^(e + 1), k = floor((e + 1) / 2) */
+	*k = (_sllbits((ull) x) - 32) >> 1;
+	x = (*k > 0) ? x >> (2 * *k): x << (-2 * *k);
+
+	y = _slladd(0x00000001dbd617a0LL, sllmul(x, _slladd(
+		(sll) 0xfffffffee458684fULL, sllmul(x, 0x0000000044ee734fLL))));
+	for (i = 0; i < 3; i++)
+		y = slldiv2(sllmul(y, _sllsub(CONST_3, sllmul(x, sllmul(y,
+			y)))));
+
+	return y;
+}
+
+/*
+ * Calculate 1 / x^(1 / 2)
+ */
+
+sll sllrsqrt(sll x)
+{
+	int k;
+	sll y;
+
+	if (x <= CONST_0)
+		return CONST_MAX;
+
+	y = _sllrsqrt(x, &k);
+
+	return (k > 0) ? (y + ((sll) 1 << (k - 1))) >> k: y << -k;
+}
+
+/*
+ * m^(-1 / 3) at each quarter of 1 <= m <= 8
+ */
+
+static const sll _sllrcbrt_k[29] = {
+	0x0000000100000000LL, 0x00000000eda63bb0LL, 0x00000000dfa2f826LL,
+	0x00000000d46f82feLL, 0x00000000cb2ff52aLL, 0x00000000c35d5412LL,
+	0x00000000bc9f5671LL, 0x00000000b6b95beeLL, 0x00000000b1801fdeLL,
+	0x00000000acd3c594LL, 0x00000000a89c38caLL, 0x00000000a4c6dff8LL,
+	0x00000000a14517ccLL, 0x000000009e0b2b28LL, 0x000000009b0f9ae5LL,
+	0x00000000984a9a55LL, 0x0000000095b5af70LL, 0x00000000934b6bc5LL,
+	0x00000000910736ebLL, 0x000000008ee52592LL, 0x000000008ce1d9c7LL,
+	0x000000008afa6a22LL, 0x00000000892c4e11LL, 0x0000000087754e1cLL,
+	0x0000000085d37730LL, 0x0000000084451046LL, 0x0000000082c891eaLL,
+	0x00000000815c9f36LL, 0x0000000080000000LL
+};
+
+/*
+ * Calculate the cube root
+ *
+ * Description
+ *
+ *	|x| = m * 8^q with 1 <= m < 8 is found from the leading bit, and
+ *	x^(1 / 3) = sign(x) * 2^q * m * r^2, where r = m^(-1 / 3).  The table
+ *	gives r to 0.4% by linear interpolation, and the division free Newton
+ *	step
+ *
+ *	r = r + r * (1 - m * r^3) / 3
+ *
+ *	roughly squares the error.  Two steps in sll give r to 2^-30, and a
+ *	last one with m and r kept to 60 and 62 bits gives it to 2^-58, so
+ *	the result is rounded once, and is good to the last bit even near
+ *	2^21.
+ */
+
+sll sllcbrt(sll x)
+{
+	int e, q;
+	int i;
+	ull u;
+	sll m, r, t;
+
+	if (x == CONST_0)
+		return CONST_0;
+
+	/* 2^e <= |x| < 2^(e + 1), q = floor((e - 32) / 3) */
+	u = (x < CONST_0) ? 0 - (ull) x: (ull) x;
+	e = _sllbits(u) - 1;
+	q = (e + 1) / 3 - 11;
+
+	/* m * 2^60 */
+	m = (sll) ((28 - 3 * q >= 0) ? u << (28 - 3 * q): u >> (3 * q - 28));
+
+	i = (int) (m >> 58) - 4;
+	r = _slladd(_sllrcbrt_k[i], sllmul((m >> 26) & 0xffffffffLL,
+		_sllsub(_sllrcbrt_k[i + 1], _sllrcbrt_k[i])));
+	for (i = 0; i < 2; i++) {
+		t = sllmul(m >> 28, sllmul(r, sllmul(r, r)));
+		r = _slladd(r, sllmul(r, _sllsub(CONST_1, t)) / 3);
+	}
+
+	r <<= 30;
+	t = _sllmulk(m, _sllmulk(r, _sllmulk(r, r, 62), 62), 60);
+	r += _sllmulk(r, ((sll) 1 << 62) - t, 62) / 3;
+
+	/* m * r^2 * 2^61, then 2^q */
+	t = _sllmulk(m, _sllmulk(r, r, 62), 61);
+	t = (t + ((sll) 1 << (28 - q))) >> (29 - q);
+
+	return (x < CONST_0) ? _sllneg(t): t;
+}
+
+/*
+ * Calculate the n-th root
+ *
+ * Description
+ *
+ *	Square and cube roots are left to sllsqrt() and sllcbrt().  Others
+ *	are e^(ln |x| / n), and above 1 take one Newton step
+ *
+ *	y = y + (x - y^n) / (n * y^(n - 1))
+ *
+ *	where x - y^n is exact, so y is good to the last bit however large.
+ *	Odd roots of x < 0 are negative.  Even roots of x < 0 aren't real,
+ *	and 0 is returned, as for n = 0.  For n < 0, 1 over the root of
+ *	1 / |x| < 1 loses precision, so the root of 1 / x is taken instead.
+ */
+
+static sll _sllroot(sll x, unsigned n)
+{
+	int neg;
+	sll p, y;
+	sllacc a;
+
+	switch (n) {
+	case 0:
+		return CONST_0;
+	case 1:
+		return x;
+	case 2:
+		return sllsqrt(x);
+	case 3:
+		return sllcbrt(x);
+	}
+
+	if (x == CONST_0)
+		return CONST_0;
+
+	neg = x < CONST_0;
+	if (neg)
+		x = (x == CONST_MIN) ? CONST_MAX: _sllneg(x);
+
+	/* n may be 2^31, which _int2sll() can't take */
+	y = sllexp(slllog(x) / (sll) n);
+	if (y > CONST_1) {
+		p = sllpowi(y, (int) (n - 1));
+		sllacczero(&a);
+		sllaccadd(&a, x);
+		sllaccmac(&a, _sllneg(p), y);
+		y = _slladd(y, _sllratio(_sllaccshift(&a, 32), p) / (sll) n);
+	}
+
+	return (neg) ? _sllneg(y): y;
+}
+
+sll sllroot(sll x, int n)
+{
+	unsigned u;
+	sll y;
+
+	u = (n < 0) ? 0 - (unsigned) n: (unsigned) n;
+	if (x < CONST_0 && !(u & 1))
+		return CONST_0;
+	if (n >= 0)
+		return _sllroot(x, u);
+
+	/* Where 1 / x is under 2^30, as _sllratio() scales through 2^31 */
+	if (_sllabs(x) < CONST_1 && _sllabs(x) >= 4)
+		return _sllroot(_sllratio(CONST_1, x), u);
+
+	y = _sllroot(x, u);
+
+	return (y == CONST_0) ? CONST_MAX: _sllratio(CONST_1, y);
+}
+
+/*
+ * Calculate the hypotenuse
+ *
+ * Description
+ *
+ *	Squaring overflows for magnitudes above 2^15.5 and underflows below
+ *	2^-16, so scale by the larger magnitude instead:
+ *	(x^2 + y^2)^(1 / 2) = max * (1 + (min / max)^2)^(1 / 2)
+ */
+
+sll sllhypot(sll x, sll y)
+{
+	sll t;
+
+	if (x < CONST_0)
+		x = _sllneg(x);
+	if (y < CONST_0)
+		y = _sllneg(y);
+
+	/* Let x be the larger */
+	if (x < y) {
+		t = x;
+		x = y;
+		y = t;
+	}
+
+	if (y == CONST_0)
+		return x;
+
+	t = _sllratio(y, x);
+
+	return sllmul(x, sllsqrt(_slladd(CONST_1, sllmul(t, t))));
+}
+
+/*
+ * erf x on each half of 0 <= x < 5, as a polynomial in x - c, where c is
+ * the middle of the half.  Fitted through 9 Chebyshev nodes.
+ */
+
+static const sll _sllerf_k[10][9] = {
+	{
+		0x0000000046bd5389LL, 0x000000010f5d15fdLL,
+		(sll) 0xffffffffbc28ba83ULL, (sll) 0xffffffffb0da33d3ULL,
+		0x000000002081cdd2LL, 0x00000000147d4192LL,
+		(sll) 0xfffffffff5a06fe4ULL, (sll) 0xfffffffffbf450cfULL,
+		0x00000000026a9895LL
+	},
+	{
+		0x00000000b60e4badLL, 0x00000000a4972175LL,
+		(sll) 0xffffffff848ea6efULL, 0x0000000006db99efLL,
+		0x0000000026936c2aLL, (sll) 0xfffffffff2605dadULL,
+		(sll) 0xfffffffff91ecef4ULL, 0x0000000004942252LL,
+		0x0000000000987966LL
+	},
+	{
+		0x00000000ec432eccLL, 0x000000003c8ca5f4LL,
+		(sll) 0xffffffffb450308bULL, 0x000000002ae3a1d3LL,
+		(sll) 0xfffffffffe6c57dbULL, (sll) 0xfffffffff3eb94daULL,
+		0x000000000573a906LL, 0x0000000000f571d0LL,
+		(sll) 0xfffffffffe91dd3dULL
+	},
+	{
+		0x00000000fc9683c0LL, 0x000000000d82a980LL,
+		(sll) 0xffffffffe85b575eULL, 0x0000000017148df4LL,
+		(sll) 0xfffffffff3af9201ULL, 0x0000000001b1bf8dLL,
+		0x00000000024b96faLL, (sll) 0xfffffffffe7b2b26ULL,
+		0x00000000002bd2c1LL
+	},
+	{
+		0x00000000ffa023b0LL, 0x0000000001d4143bLL,
+		(sll) 0xfffffffffbe2d27cULL, 0x00000000058fbcd6LL,
+		(sll) 0xfffffffffb1d59ecULL, 0x0000000002ba9e26LL,
+		(sll) 0xffffffffff41aa8cULL, (sll) 0xffffffffffd0b685ULL,
+		0x00000000004160b6LL
+	},
+	{
+		0x00000000fff967d8LL, 0x0000000000266c1aLL,
+		(sll) 0xffffffffff9656b9ULL, 0x0000000000b4e77fLL,
+		(sll) 0xffffffffff2a7a07ULL, 0x0000000000b4a2e2LL,
+		(sll) 0xffffffffff935c98ULL, 0x000000000029ab46LL,
+		(sll) 0xfffffffffffaac22ULL
+	},
+	{
+		0x00000000ffffb7d0LL, 0x000000000001e9b6LL,
+		(sll) 0xfffffffffff9c871ULL, 0x00000000000cd531LL,
+		(sll) 0xffffffffffed3829ULL, 0x0000000000148dd1LL,
+		(sll) 0xffffffffffeebaf5ULL, 0x00000000000b607aLL,
+		(sll) 0xfffffffffffaa11bULL
+	},
+	{
+		0x00000000fffffe18LL, 0x0000000000000ecaLL,
+		(sll) 0xffffffffffffc88cULL, 0x00000000000085b8LL,
+		(sll) 0xffffffffffff17c7ULL, 0x0000000000013387LL,
+		(sll) 0xfffffffffffebcf2ULL, 0x0000000000011fa3LL,
+		(sll) 0xffffffffffff3f23ULL
+	},
+	{
+		0x00000000fffffff8LL, 0x0000000000000045LL,
+		(sll) 0xfffffffffffffed9ULL, 0x000000000000032cLL,
+		(sll) 0xfffffffffffff9a5ULL, 0x00000000000009cdLL,
+		(sll) 0xfffffffffffff3c5ULL, 0x0000000000000da7LL,
+		(sll) 0xfffffffffffff4a3ULL
+	},
+	{
+		0x0000000100000000LL, 0x0000000000000001LL,
+		(sll) 0xfffffffffffffffcULL, 0x000000000000000bLL,
+		(sll) 0xffffffffffffffe6ULL, 0x000000000000002dLL,
+		(sll) 0xffffffffffffffbfULL, 0x0000000000000057LL,
+		(sll) 0xffffffffffffffabULL
+	}
+};
+
+/*
+ * Calculate the error function
+ *
+ * Description
+ *
+ *	erf is odd, and rounds to 1 from about 4.62.  Below 5, the polynomial
+ *	of the half of x is taken in t = x - c, where |t| <= 1 / 4, with the
+ *	last multiply rounded.  That is good to about an ulp, and needs no
+ *	e^x.
+ */
+
+sll sllerf(sll x)
+{
+	int i;
+	sll t;
+	sll retval;
+	const sll *k;
+
+	if (x >= _int2sll(5))
+		return CONST_1;
+	if (x <= _sllneg(_int2sll(5)))
+		return _sllneg(CONST_1);
+
+	t = _sllabs(x);
+	i = (int) (t >> 31);
+	k = _sllerf_k[i];
+	t = _sllsub(t, (sll) (2 * i + 1) << 30);
+
+	for (retval = k[8], i = 7; i > 0; i--)
+		retval = _slladd(k[i], sllmul(t, retval));
+	retval = _slladd(k[0], _sllmulk(t, retval, 32));
+
+	return (x < CONST_0) ? _sllneg(retval): retval;
+}
+
+/*
+ * Calculate the complementary error function
+ */
+
+sll sllerfc(sll x)
+{
+	return _sllsub(CONST_1, sllerf(x));
+}
+
+/*
+ * 1 / sqrt(2) * 2^62, for _sllmulk()
+ */
+
+#define _SLL_1_SQRT2_62	0x2d413cccfe779921LL
+
+/*
+ * Calculate the standard normal cumulative distribution
+ *
+ * Description
+ *
+ *	PHI(x) = (1 + erf(x / sqrt(2))) / 2
+ *
+ *	with x / sqrt(2) rounded once from a 62 bit constant.
+ */
+
+sll sllnormcdf(sll x)
+{
+	return slldiv2(_slladd(CONST_1, sllerf(_sllmulk(x, _SLL_1_SQRT2_62,
+		62))));
+}
+
+/*
+ * Coefficients of the central and tail rational functions of
+ * sllnorminv(), after P. J. Acklam
+ */
+
+static const sll _sllnorminv_a[6] = {
+	(sll) 0xffffffd84d9c87c4ULL, 0x000000dcf23381a0LL,
+	(sll) 0xfffffeec124d23acULL, 0x0000008a5b95a05aLL,
+	(sll) 0xffffffe155cfcb3fULL, 0x0000000281b2640bLL
+};
+
+static const sll _sllnorminv_b[5] = {
+	(sll) 0xffffffc9861e63a0ULL, 0x000000a195f96782LL,
+	(sll) 0xffffff644d0fa7e9ULL, 0x00000042cd22c6a0LL,
+	(sll) 0xfffffff2b82540f6ULL
+};
+
+static const sll _sllnorminv_c[6] = {
+	(sll) 0xfffffffffe01cf27ULL, (sll) 0xffffffffad776cfcULL,
+	(sll) 0xfffffffd9967e7d2ULL, (sll) 0xfffffffd7344ba72ULL,
+	0x000000045fe9fd3bLL, 0x00000002f02b83c8LL
+};
+
+static const sll _sllnorminv_d[4] = {
+	0x0000000001fe2d85LL, 0x00000000528d34adLL, 0x0000000271f44f91LL,
+	0x00000003c120ed13LL
+};
+
+/*
+ * Lower tail of sllnorminv(), for 0 < p < 0.02425
+ */
+
+static sll _sllnorminvtail(sll p)
+{
+	int i;
+	sll q;
+	sll num, den;
+
+	q = sllsqrt(_sllneg(sllmul2(slllog(p))));
+
+	for (num = _sllnorminv_c[0], i = 1; i < 6; i++)
+		num = _slladd(_sllnorminv_c[i], sllmul(q, num));
+	for (den = _sllnorminv_d[0], i = 1; i < 4; i++)
+		den = _slladd(_sllnorminv_d[i], sllmul(q, den));
+	den = _slladd(CONST_1, sllmul(q, den));
+
+	return _sllratio(num, den);
+}
+
+/*
+ * Calculate the inverse of the standard normal cumulative distribution
+ *
+ * Description
+ *
+ *	Rational functions of r = (p - 1 / 2)^2 in the middle, and of
+ *	q = (-2 * ln p)^(1 / 2) in the tails, which are symmetric, with a
+ *	relative error under 1.15e-9.  In the tails that is finer than p,
+ *	good only to 2^-32, can resolve.  In the middle the denominator falls
+ *	to 0.004 near the tails and loses bits in sll, so one Newton step on
+ *	sllnormcdf() brings x to within a few ulps of what p resolves.
+ *	Returns CONST_MIN for p <= 0 and CONST_MAX for p >= 1.
+ */
+
+sll sllnorminv(sll p)
+{
+	int i;
+	sll q, r;
+	sll num, den;
+
+	if (p <= CONST_0)
+		return CONST_MIN;
+	if (p >= CONST_1)
+		return CONST_MAX;
+
+	/* 0.02425 */
+	if (p < 0x0000000006353f7dLL)
+		return _sllnorminvtail(p);
+	if (p > _sllsub(CONST_1, 0x0000000006353f7dLL))
+		return _sllneg(_sllnorminvtail(_sllsub(CONST_1, p)));
+
+	q = _sllsub(p, CONST_1_2);
+	r = sllmul(q, q);
+
+	for (num = _sllnorminv_a[0], i = 1; i < 6; i++)
+		num = _slladd(_sllnorminv_a[i], sllmul(r, num));
+	for (den = _sllnorminv_b[0], i = 1; i < 5; i++)
+		den = _slladd(_sllnorminv_b[i], sllmul(r, den));
+	den = _slladd(CONST_1, sllmul(r, den));
+	r = _sllratio(sllmul(num, q), den);
+
+	/* Newton step, x - (PHI(x) - p) * sqrt(2 * PI) * e^(x^2 / 2) */
+	q = _sllsub(sllnormcdf(r), p);
+
+	return _sllsub(r, sllmul(q, sllmul(0x0000000281b263ffLL,
+		sllexp(slldiv2(sllmul(r, r))))));
+}
+
+/*
+ * Error function and normal distribution of arrays
+ */
+
+void sllerfv(sll *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = sllerf(x[i]);
+}
+
+void sllerfcv(sll *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = sllerfc(x[i]);
+}
+
+void sllnormcdfv(sll *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = sllnormcdf(x[i]);
+}
+
+void sllnorminvv(sll *y, const sll *p, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = sllnorminv(p[i]);
+}
+
+/*
+ * n! for 0 <= n <= 12, the largest that fits
+ */
+
+static const sll _sllfact_k[13] = {
+	CONST_FACT_0, CONST_FACT_1, CONST_FACT_2, CONST_FACT_3, CONST_FACT_4,
+	CONST_FACT_5, CONST_FACT_6, CONST_FACT_7, CONST_FACT_8, CONST_FACT_9,
+	CONST_FACT_10, CONST_FACT_11, CONST_FACT_12
+};
+
+/*
+ * ln n! for 0 <= n < 32
+ */
+
+static const sll _slllogfact_k[32] = {
+	0x0000000000000000LL, 0x0000000000000000LL, 0x00000000b17217f8LL,
+	0x00000001cab0bfa3LL, 0x000000032d94ef92LL, 0x00000004c9990f11LL,
+	0x000000069449ceb4LL, 0x000000088670f997LL, 0x0000000a9ac7417eLL,
+	0x0000000ccd4490d4LL, 0x0000000f1abac84bLL, 0x0000001180973f3bLL,
+	0x00000013fcba16d5LL, 0x000000168d5a9c3bLL, 0x0000001930f3df16LL,
+	0x0000001be636a640LL, 0x0000001eabff061fLL, 0x00000021814c7e5eLL,
+	0x00000024653be5acLL, 0x000000275702a66cLL, 0x0000002a55eaf5dbLL,
+	0x0000002d6150c869LL, 0x00000030789f5751LL, 0x000000339b4f170bLL,
+	0x00000036c8e4069dLL, 0x0000003a00ec459bLL, 0x0000003d42fee2f9LL,
+	0x000000408ebad9f9LL, 0x00000043e3c634ccLL, 0x0000004741cd4e46LL,
+	0x0000004aa8822d67LL, 0x0000004e179bf679LL
+};
+
+/*
+ * ln GAMMA(x) for 2 <= x <= 3, as a polynomial in x - 5 / 2.  Fitted
+ * through 10 Chebyshev nodes.
+ */
+
+static const sll _slllgamma_p[10] = {
+	0x0000000048e0fa03LL, 0x00000000b40212d8LL, 0x000000003ec40aecLL,
+	(sll) 0xfffffffff5ec05a1ULL, 0x0000000002636bf2LL,
+	(sll) 0xffffffffff54a4ddULL, 0x0000000000348ed5LL,
+	(sll) 0xffffffffffeee642ULL, 0x00000000000643f8LL,
+	(sll) 0xfffffffffffdd14eULL
+};
+
+static sll _slllgamma23(sll y)
+{
+	int i;
+	sll retval;
+
+	y = _sllsub(y, 0x0000000280000000LL);
+	for (retval = _slllgamma_p[9], i = 8; i > 0; i--)
+		retval = _slladd(_slllgamma_p[i], sllmul(y, retval));
+
+	return _slladd(_slllgamma_p[0], _sllmulk(y, retval, 32));
+}
+
+/*
+ * 1 / 12, -1 / 360, 1 / 1260 and -1 / 1680, for the Stirling series, and
+ * ln(2 * PI) / 2 and ln PI
+ */
+
+static const sll _slllgamma_k[4] = {
+	0x0000000015555555LL, (sll) 0xffffffffff49f49fULL,
+	0x0000000000340340LL, (sll) 0xffffffffffd8fd90ULL
+};
+
+#define _SLL_LN_2PI_2	0x00000000eb3f8e43LL
+#define _SLL_LN_PI	0x00000001250d048eLL
+
+/*
+ * Calculate ln |GAMMA(x)|
+ *
+ * Description
+ *
+ *	Integers below 33 come from the table of ln n!.  Below 13, x is
+ *	moved to y in 2 <= y < 3 by
+ *
+ *	ln GAMMA(x) = ln GAMMA(y) + ln(y * (y + 1) * ... * (x - 1))
+ *	ln GAMMA(x) = ln GAMMA(y) - ln x - ln((x + 1) * ... * (y - 1))
+ *
+ *	upwards or downwards, with ln x apart and ln(1 + x) from slllog1p(),
+ *	so tiny x keep their precision.  ln GAMMA(y) is a polynomial.  From
+ *	13, the Stirling series
+ *
+ *	ln GAMMA(x) = (x - 1 / 2) * (ln x - 1) - 1 / 2 + ln(2 * PI) / 2
+ *		+ 1 / (12 * x) - 1 / (360 * x^3) + 1 / (1260 * x^5)
+ *		- 1 / (1680 * x^7)
+ *
+ *	is good to 2^-43, but the error of ln x is multiplied by x - 1 / 2.
+ *	For x <= 0,
+ *
+ *	ln |GAMMA(x)| = ln PI - ln sin(PI * f) - ln GAMMA(1 - x)
+ *
+ *	with f the fraction of x.  Saturates above 121887255, where the
+ *	result passes 2^31, and at the poles.
+ */
+
+sll slllgamma(sll x)
+{
+	sll p, r, t;
+	sll retval;
+
+	if (x <= CONST_0) {
+		t = sllfrac(x);
+		if (t == CONST_0)
+			return CONST_MAX;
+		if (x < _sllneg(_int2sll(121887254)))
+			return CONST_MIN;
+		return _sllsub(_sllsub(_SLL_LN_PI, slllog(sllsin(sllmul(CONST_PI,
+			t)))), slllgamma(_sllsub(CONST_1, x)));
+	}
+	if (x > _int2sll(121887255))
+		return CONST_MAX;
+	if (sllfrac(x) == CONST_0 && x <= _int2sll(32))
+		return _slllogfact_k[_sll2int(x) - 1];
+
+	if (x < _int2sll(13)) {
+		if (x < CONST_1) {
+			t = _sllneg(_slladd(slllog(x), slllog1p(x)));
+			r = _slladd(x, CONST_2);
+		} else if (x < CONST_2) {
+			t = _sllneg(slllog(x));
+			r = _slladd(x, CONST_1);
+		} else {
+			r = _slladd(_int2sll(2), sllfrac(x));
+			for (p = CONST_1, t = r; t < x; t = _slladd(t, CONST_1))
+				p = sllmul(p, t);
+			t = (p == CONST_1) ? CONST_0: slllog(p);
+		}
+
+		return _slladd(_slllgamma23(r), t);
+	}
+
+	r = _sllratio(CONST_1, x);
+	p = sllmul(r, r);
+	retval = _slladd(_slllgamma_k[2], sllmul(p, _slllgamma_k[3]));
+	retval = _slladd(_slllgamma_k[1], sllmul(p, retval));
+	retval = sllmul(r, _slladd(_slllgamma_k[0], sllmul(p, retval)));
+
+	retval = _slladd(retval, _sllsub(_SLL_LN_2PI_2, CONST_1_2));
+
+	return slladdsat(sllmulsat(_sllsub(x, CONST_1_2),
+		_sllsub(slllog(x), CONST_1)), retval);
+}
+
+/*
+ * Calculate GAMMA(x)
+ *
+ * Description
+ *
+ *	Integers up to 13 come from the table of n!.  Otherwise, for
+ *	0 < x < 14, x is moved to 2 <= y < 3 as in slllgamma(), and GAMMA(y),
+ *	from 1 to 2, is multiplied by y * (y + 1) * ... * (x - 1), or divided
+ *	by x and x + 1, so the relative error stays that of e^x.  For x < 0,
+ *	e^(ln |GAMMA(x)|) is negative when floor(x) is odd.  Saturates at the
+ *	poles, below 3 * 2^-32, and above 13.6, where GAMMA(x) passes 2^31.
+ */
+
+sll sllgamma(sll x)
+{
+	sll t;
+	sll retval;
+
+	if (sllfrac(x) == CONST_0) {
+		if (x <= CONST_0 || x > _int2sll(13))
+			return CONST_MAX;
+		return _sllfact_k[_sll2int(x) - 1];
+	}
+
+	if (x < CONST_0) {
+		retval = sllexp(slllgamma(x));
+		return (_sll2int(x) & 1) ? _sllneg(retval): retval;
+	}
+	if (x >= _int2sll(14) || x < (sll) 3)
+		return CONST_MAX;
+
+	if (x < CONST_1)
+		return _sllratio(_sllratio(sllexp(_slllgamma23(_slladd(x,
+			CONST_2))), _slladd(x, CONST_1)), x);
+	if (x < CONST_2)
+		return _sllratio(sllexp(_slllgamma23(_slladd(x, CONST_1))), x);
+
+	t = _slladd(_int2sll(2), sllfrac(x));
+	for (retval = sllexp(_slllgamma23(t)); t < x; t = _slladd(t, CONST_1))
+		retval = sllmulsat(retval, t);
+
+	return retval;
+}
+
+/*
+ * Calculate n!
+ *
+ * Description
+ *
+ *	From the table, saturating above 12.  0 for n < 0.
+ */
+
+sll sllfact(int n)
+{
+	if (n < 0)
+		return CONST_0;
+	if (n > 12)
+		return CONST_MAX;
+
+	return _sllfact_k[n];
+}
+
+/*
+ * Calculate ln n!
+ *
+ * Description
+ *
+ *	From the table below 32, and slllgamma(n + 1) above.  CONST_MIN for
+ *	n < 0.
+ */
+
+sll slllogfact(int n)
+{
+	if (n < 0)
+		return CONST_MIN;
+	if (n < 32)
+		return _slllogfact_k[n];
+
+	return slllgamma(_slladd(_int2sll(n), CONST_1));
+}
+
+/*
+ * Calculate the binomial coefficient n! / (k! * (n - k)!)
+ *
+ * Description
+ *
+ *	c = c * (n - k + i) / i for i = 1 .. k, with k <= n - k, keeps c an
+ *	integer, and is exact until it saturates above 2^31.  0 unless
+ *	0 <= k <= n.
+ */
+
+sll sllbinom(int n, int k)
+{
+	int i;
+	ull c;
+
+	if (k < 0 || k > n)
+		return CONST_0;
+	if (k > n - k)
+		k = n - k;
+
+	for (c = 1, i = 1; i <= k; i++) {
+		c = c * (ull) (n - k + i) / (ull) i;
+		if (c > 0x7fffffffULL)
+			return CONST_MAX;
+	}
+
+	return _int2sll(c);
+}
+
+/*
+ * Calculate ln of the binomial coefficient
+ */
+
+sll slllogbinom(int n, int k)
+{
+	if (k < 0 || k > n)
+		return CONST_MIN;
+
+	return sllsubsat(slllogfact(n), slladdsat(slllogfact(k),
+		slllogfact(n - k)));
+}
+
+/*
+ * Calculate the binomial probability of k successes in n trials
+ *
+ * Description
+ *
+ *	e^(ln C(n, k) + k * ln p + (n - k) * ln(1 - p)), with ln(1 - p)
+ *	from slllog1p() and the products saturating, so a vanishing
+ *	probability comes out as 0.  The error of the logarithms is
+ *	multiplied by k and n - k, so the relative error grows with n.
+ */
+
+sll sllbinompmf(int n, int k, sll p)
+{
+	sll t;
+
+	if (k < 0 || k > n)
+		return CONST_0;
+	if (p <= CONST_0)
+		return (k == 0) ? CONST_1: CONST_0;
+	if (p >= CONST_1)
+		return (k == n) ? CONST_1: CONST_0;
+
+	t = slladdsat(sllmulsat(_int2sll(k), slllog(p)),
+		sllmulsat(_int2sll(n - k), slllog1p(_sllneg(p))));
+
+	return sllexp(slladdsat(slllogbinom(n, k), t));
+}
+
+/*
+ * Calculate the Poisson probability of k with mean lambda
+ *
+ * Description
+ *
+ *	e^(k * ln lambda - lambda - ln k!), where the error grows with k as
+ *	in sllbinompmf().
+ */
+
+sll sllpoissonpmf(int k, sll lambda)
+{
+	sll t;
+
+	if (k < 0 || lambda < CONST_0)
+		return CONST_0;
+	if (lambda == CONST_0)
+		return (k == 0) ? CONST_1: CONST_0;
+
+	t = sllsubsat(sllmulsat(_int2sll(k), slllog(lambda)), lambda);
+
+	return sllexp(sllsubsat(t, slllogfact(k)));
+}
+
+/*
+ * Gamma functions of arrays
+ */
+
+void slllgammav(sll *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = slllgamma(x[i]);
+}
+
+void sllgammav(sll *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = sllgamma(x[i]);
+}
+
+/*
+ * Binomial probabilities of 0 <= k <= n
+ *
+ * Description
+ *
+ *	Only the mode m = floor((n + 1) * p) takes sllbinompmf().  The rest
+ *	follow by the ratios
+ *
+ *	P(k + 1) = P(k) * (n - k) * p / ((k + 1) * (1 - p))
+ *
+ *	outwards from it, so the probabilities fall away from the largest,
+ *	and their errors with them.
+ */
+
+void sllbinompmfv(sll *y, int n, sll p)
+{
+	int k, m;
+	sll q;
+
+	if (n < 0)
+		return;
+	if (p <= CONST_0 || p >= CONST_1) {
+		for (k = 0; k <= n; k++)
+			y[k] = sllbinompmf(n, k, p);
+		return;
+	}
+
+	q = _sllsub(CONST_1, p);
+	m = _sll2int(sllmul(_int2sll(n + 1), p));
+	if (m > n)
+		m = n;
+
+	y[m] = sllbinompmf(n, m, p);
+	for (k = m; k < n; k++)
+		y[k + 1] = _sllratio(sllmul(y[k] * (sll) (n - k), p),
+			sllmul(_int2sll(k + 1), q));
+	for (k = m; k > 0; k--)
+		y[k - 1] = _sllratio(sllmul(y[k] * (sll) k, q),
+			sllmul(_int2sll(n - k + 1), p));
+}
+
+/*
+ * Poisson probabilities of 0 <= k < n
+ *
+ * Description
+ *
+ *	As sllbinompmfv(), from the mode m = floor(lambda), with
+ *
+ *	P(k + 1) = P(k) * lambda / (k + 1)
+ */
+
+void sllpoissonpmfv(sll *y, int n, sll lambda)
+{
+	int k, m;
+
+	if (n <= 0)
+		return;
+	if (lambda <= CONST_0) {
+		for (k = 0; k < n; k++)
+			y[k] = sllpoissonpmf(k, lambda);
+		return;
+	}
+
+	m = _sll2int(lambda);
+	if (m > n - 1)
+		m = n - 1;
+
+	y[m] = sllpoissonpmf(m, lambda);
+	for (k = m; k < n - 1; k++)
+		y[k + 1] = sllmul(y[k], lambda) / (sll) (k + 1);
+	for (k = m; k > 0; k--)
+		y[k - 1] = _sllratio(y[k] * (sll) k, lambda);
+}
+
+/*
+ * Add a 64.64 value to a wide accumulator
+ */
+
+static __inline__ void _sllaccadd128(sllacc *a, sll hi, ull lo)
+{
+	a->lo += lo;
+	a->hi += hi + (a->lo < lo);
+}
+
+/*
+ * Add an sll to a wide accumulator
+ */
+
+void sllaccadd(sllacc *a, sll x)
+{
+	_sllaccadd128(a, x >> 32, (ull) x << 32);
+}
+
+/*
+ * Add an exact product to a wide accumulator
+ */
+
+void sllaccmac(sllacc *a, sll x, sll y)
+{
+	sll hi;
+	ull lo;
+
+	_sllmul128(x, y, &hi, &lo);
+	_sllaccadd128(a, hi, lo);
+}
+
+/*
+ * Subtract an exact product from a wide accumulator
+ *
+ * Description
+ *
+ *	Negating the 128 bit product:  -(hi * 2^64 + lo) = ~hi * 2^64 + -lo,
+ *	plus a carry into the high half when lo is 0.
+ */
+
+void sllaccmsub(sllacc *a, sll x, sll y)
+{
+	sll hi;
+	ull lo;
+
+	_sllmul128(x, y, &hi, &lo);
+	_sllaccadd128(a, ~hi + (lo == 0), -lo);
+}
+
+/*
+ * Divide a wide accumulator by a positive integer
+ *
+ * Description
+ *
+ *	Schoolbook long division of the magnitude, one 32 bit digit at a time,
+ *	so each step divides a 64 bit value by d.  The quotient is rounded
+ *	down, as sllacc2sll() does, so a negative one is rounded away from 0
+ *	when anything is left over.
+ */
+
+sll sllaccdivi(const sllacc *a, int d)
+{
+	int i;
+	int sgn;
+	ull hi;
+	ull lo;
+	ull r;
+	unsigned w[4];
+	unsigned q[4];
+
+	hi = (ull) a->hi;
+	lo = a->lo;
+
+	/* Magnitude of the 128 bit value */
+	if ((sgn = a->hi < 0)) {
+		lo = -lo;
+		hi = ~hi + (lo == 0);
+	}
+
+	w[0] = (unsigned) (hi >> 32);
+	w[1] = (unsigned) hi;
+	w[2] = (unsigned) (lo >> 32);
+	w[3] = (unsigned) lo;
+
+	for (r = 0, i = 0; i < 4; i++) {
+		r = (r << 32) | w[i];
+		q[i] = (unsigned) (r / (unsigned) d);
+		r %= (unsigned) d;
+	}
+
+	/* The middle 64 bits are the 32.32 result, floored */
+	if (sgn && (r != 0 || q[3] != 0))
+		r = (((ull) q[1] << 32) | q[2]) + 1;
+	else
+		r = ((ull) q[1] << 32) | q[2];
+
+	return ((sgn) ? _sllneg((sll) r): (sll) r);
+}
+
+/*
+ * Fused multiply-add
+ */
+
+sll sllfma(sll x, sll y, sll z)
+{
+	sllacc acc;
+
+	sllacczero(&acc);
+	sllaccadd(&acc, z);
+	sllaccmac(&acc, x, y);
+
+	return sllacc2sll(&acc);
+}
+
+/*
+ * Merge two wide accumulators
+ */
+
+void sllaccmerge(sllacc *a, const sllacc *b)
+{
+	_sllaccadd128(a, b->hi, b->lo);
+}
+
+/*
+ * Shift a wide accumulator, returning the low 64 bits
+ *
+ * Description
+ *
+ *	Shifts right, arithmetically, by s when s > 0, and left by -s
+ *	otherwise, where -64 < s < 128.
+ */
+
+static sll _sllaccshift(const sllacc *a, int s)
+{
+	if (s <= -64 || s >= 128)
+		return CONST_0;
+	if (s < 0)
+		return (sll) (a->lo << -s);
+	if (s == 0)
+		return (sll) a->lo;
+	if (s < 64)
+		return (sll) ((a->lo >> s) | ((ull) a->hi << (64 - s)));
+
+	return a->hi >> (s - 64);
+}
+
+/*
+ * Number of significant bits in a non-negative wide accumulator
+ */
+
+static int _sllaccbits(const sllacc *a)
+{
+	int n;
+	ull u;
+
+	if (a->hi) {
+		n = 64;
+		u = (ull) a->hi;
+	} else {
+		n = 0;
+		u = a->lo;
+	}
+	for (; u; u >>= 1)
+		n++;
+
+	return n;
+}
+
+/*
+ * Accumulate a strided dot product
+ */
+
+static void _slldot(sllacc *acc, const sll *a, int sa, const sll *b, int sb,
+	int n)
+{
+	int k;
+
+	for (k = 0; k < n; k++)
+		sllaccmac(acc, a[k * sa], b[k * sb]);
+}
+
+/*
+ * Matrix product c = a * b, where a is n x m and b is m x p
+ */
+
+void sllmatmul(sll *c, const sll *a, const sll *b, int n, int m, int p)
+{
+	int i, j;
+	sllacc acc;
+
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < p; j++) {
+			sllacczero(&acc);
+			_slldot(&acc, &a[i * m], 1, &b[j], p, m);
+			c[i * p + j] = sllacc2sll(&acc);
+		}
+	}
+}
+
+/*
+ * Matrix product c = a * b^T, where a is n x m and b is p x m
+ */
+
+void sllmatmult(sll *c, const sll *a, const sll *b, int n, int m, int p)
+{
+	int i, j;
+	sllacc acc;
+
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < p; j++) {
+			sllacczero(&acc);
+			_slldot(&acc, &a[i * m], 1, &b[j * m], 1, m);
+			c[i * p + j] = sllacc2sll(&acc);
+		}
+	}
+}
+
+/*
+ * Cholesky decomposition a = l * l^T of a positive definite matrix
+ *
+ * Description
+ *
+ *	l[j][j] = (a[j][j] - SUM[k<j] l[j][k]^2)^(1 / 2)
+ *	l[i][j] = (a[i][j] - SUM[k<j] l[i][k] * l[j][k]) / l[j][j], i > j
+ *
+ *	The sums are wide accumulations.  The upper triangle of l is set to 0.
+ *	Returns 0 if a pivot isn't positive, 1 otherwise.
+ */
+
+int sllcholesky(sll *l, const sll *a, int n)
+{
+	int i, j, k;
+	sll d;
+	sllacc acc;
+
+	for (j = 0; j < n; j++) {
+		sllacczero(&acc);
+		sllaccadd(&acc, a[j * n + j]);
+		for (k = 0; k < j; k++)
+			sllaccmsub(&acc, l[j * n + k], l[j * n + k]);
+		d = sllacc2sll(&acc);
+		if (d <= CONST_0)
+			return 0;
+		d = sllsqrt(d);
+		l[j * n + j] = d;
+
+		for (i = j + 1; i < n; i++) {
+			sllacczero(&acc);
+			sllaccadd(&acc, a[i * n + j]);
+			for (k = 0; k < j; k++)
+				sllaccmsub(&acc, l[i * n + k], l[j * n + k]);
+			l[i * n + j] = _sllratio(sllacc2sll(&acc), d);
+		}
+		for (i = 0; i < j; i++)
+			l[i * n + j] = CONST_0;
+	}
+
+	return 1;
+}
+
+/*
+ * Solve l * l^T * x = b, where l is from sllcholesky() and b is n x p
+ *
+ * Description
+ *
+ *	Forward substitution for l * y = b, then back substitution for
+ *	l^T * x = y, one column of b at a time.  x may be the same as b.
+ */
+
+void sllcholsolve(sll *x, const sll *l, const sll *b, int n, int p)
+{
+	int i, j, k;
+	sllacc acc;
+
+	for (j = 0; j < p; j++) {
+		for (i = 0; i < n; i++) {
+			sllacczero(&acc);
+			sllaccadd(&acc, b[i * p + j]);
+			for (k = 0; k < i; k++)
+				sllaccmsub(&acc, l[i * n + k], x[k * p + j]);
+			x[i * p + j] = _sllratio(sllacc2sll(&acc), l[i * n + i]);
+		}
+		for (i = n - 1; i >= 0; i--) {
+			sllacczero(&acc);
+			sllaccadd(&acc, x[i * p + j]);
+			for (k = i + 1; k < n; k++)
+				sllaccmsub(&acc, l[k * n + i], x[k * p + j]);
+			x[i * p + j] = _sllratio(sllacc2sll(&acc), l[i * n + i]);
+		}
+	}
+}
+
+/*
+ * Seed the random number generator
+ *
+ * Description
+ *
+ *	xoshiro256** must not start from an all zero state, and wants well
+ *	mixed bits, so the state is filled from splitmix64, which gives both
+ *	for any seed.
+ */
+
+void sllrngseed(sllrng *r, ull seed)
+{
+	int i;
+	ull z;
+
+	for (i = 0; i < 4; i++) {
+		seed += 0x9e3779b97f4a7c15ULL;
+		z = seed;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		r->s[i] = z ^ (z >> 31);
+	}
+
+	r->spare = CONST_0;
+	r->has_spare = 0;
+}
+
+/*
+ * Next 64 random bits, xoshiro256**
+ */
+
+static __inline__ ull _sllrotl(ull x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+ull sllrngnext(sllrng *r)
+{
+	ull retval;
+	ull t;
+
+	retval = _sllrotl(r->s[1] * 5, 7) * 9;
+	t = r->s[1] << 17;
+
+	r->s[2] ^= r->s[0];
+	r->s[3] ^= r->s[1];
+	r->s[1] ^= r->s[2];
+	r->s[0] ^= r->s[3];
+
+	r->s[2] ^= t;
+	r->s[3] = _sllrotl(r->s[3], 45);
+
+	return retval;
+}
+
+/*
+ * Uniform random value, 0 <= x < 1
+ *
+ * Description
+ *
+ *	The raw value of an sll in [0, 1) is any 32 bit fraction, so the top
+ *	32 bits of the generator, which are its best bits, are used as-is.
+ */
+
+sll sllrand(sllrng *r)
+{
+	return (sll) (sllrngnext(r) >> 32);
+}
+
+/*
+ * Uniform random value, lo <= x < hi
+ *
+ * Description
+ *
+ *	The span hi - lo is unsigned, so it may be as wide as sll allows, and
+ *	its 128 bit product with the fraction is chopped, which keeps x below
+ *	hi.  For hi <= lo, lo is returned.
+ */
+
+sll sllrandrange(sllrng *r, sll lo, sll hi)
+{
+	ull h, l;
+
+	if (hi <= lo)
+		return lo;
+
+	_sllumul128((ull) hi - (ull) lo, (ull) sllrand(r), &h, &l);
+
+	return (sll) ((ull) lo + ((h << 32) | (l >> 32)));
+}
+
+/*
+ * Standard normal random value
+ *
+ * Description
+ *
+ *	Box-Muller:  with u uniform in (0, 1] and a uniform angle t,
+ *
+ *	r = (-2 * ln u)^(1 / 2)
+ *	z0 = r * cos t
+ *	z1 = r * sin t
+ *
+ *	are independent standard normals.  The angle is taken directly as 32
+ *	random bits of binary angle, so sllsincosbam() needs no scaling by
+ *	2 * pi, and z1 is kept for the next call.
+ *
+ *	Since u >= 2^-32, |z| < 6.7, which cuts off a tail of probability
+ *	2.3e-10.
+ */
+
+sll sllrandnorm(sllrng *r)
+{
+	ull bits;
+	sll u;
+	sll rad;
+	sll s, c;
+
+	if (r->has_spare) {
+		r->has_spare = 0;
+		return r->spare;
+	}
+
+	bits = sllrngnext(r);
+
+	/* 1 - [0, 1) is (0, 1] */
+	u = _sllsub(CONST_1, (sll) (bits >> 32));
+	rad = sllsqrt(sllmul2(_sllneg(slllog(u))));
+	sllsincosbam((unsigned) bits, &s, &c);
+
+	r->spare = sllmul(rad, s);
+	r->has_spare = 1;
+
+	return sllmul(rad, c);
+}
+
+/*
+ * Exponential random value, mean 1
+ *
+ * Description
+ *
+ *	Inversion:  -ln(1 - u), with u uniform in [0, 1).
+ */
+
+sll sllrandexp(sllrng *r)
+{
+	return _sllneg(slllog1p(_sllneg(sllrand(r))));
+}
+
+/*
+ * Uniform random values, 0 <= x < 1
+ *
+ * Description
+ *
+ *	Each 64 bit draw provides two values.
+ */
+
+void sllrandv(sllrng *r, sll *x, int n)
+{
+	int i;
+	ull bits;
+
+	for (i = 0; i + 1 < n; i += 2) {
+		bits = sllrngnext(r);
+		x[i] = (sll) (bits >> 32);
+		x[i + 1] = (sll) (bits & 0xffffffffULL);
+	}
+	if (i < n)
+		x[i] = sllrand(r);
+}
+
+/*
+ * Standard normal random values
+ */
+
+void sllrandnormv(sllrng *r, sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		x[i] = sllrandnorm(r);
+}
+
+/*
+ * Add the elements of an array to a wide accumulator
+ */
+
+void sllaccsumv(sllacc *a, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		sllaccadd(a, x[i]);
+}
+
+/*
+ * Sum of an array
+ */
+
+sll sllsumv(const sll *x, int n)
+{
+	sllacc acc;
+
+	sllacczero(&acc);
+	sllaccsumv(&acc, x, n);
+
+	return sllacc2sll(&acc);
+}
+
+/*
+ * Mean of an array
+ *
+ * Description
+ *
+ *	The exact sum divided once, so the mean of values near the top of the
+ *	range is correct even though their sum isn't representable.
+ */
+
+sll sllmeanv(const sll *x, int n)
+{
+	sllacc acc;
+
+	if (n <= 0)
+		return CONST_0;
+
+	sllacczero(&acc);
+	sllaccsumv(&acc, x, n);
+
+	return sllaccdivi(&acc, n);
+}
+
+/*
+ * Divide a wide accumulator by a positive integer, saturating
+ */
+
+static sll _sllaccdivisat(const sllacc *a, int d)
+{
+	if (a->hi >= (sll) d << 31)
+		return CONST_MAX;
+	if (a->hi < -((sll) d << 31))
+		return CONST_MIN;
+
+	return sllaccdivi(a, d);
+}
+
+/*
+ * Sum of products of deviations from the means
+ *
+ * Description
+ *
+ *	SUM (x - mx) * (y - my), exactly, with the deviations saturating, or
+ *	of the deviations of x / 2^s and y / 2^s for s > 0.  Each product is
+ *	at most 2^62, so the sum can't wrap while it is within 2^62.  Once
+ *	past that it is held there and 1 is returned, as divided by n - ddof
+ *	it is out of range anyway.
+ */
+
+static int _sllcomoment(sllacc *acc, const sll *x, sll mx, const sll *y,
+	sll my, int n, int s)
+{
+	int i;
+
+	sllacczero(acc);
+	for (i = 0; i < n; i++) {
+		sllaccmac(acc, sllsubsat(x[i] >> s, mx >> s),
+			sllsubsat(y[i] >> s, my >> s));
+		if (acc->hi >= ((sll) 1 << 62) || acc->hi < -((sll) 1 << 62)) {
+			acc->hi = (acc->hi < 0) ? -((sll) 1 << 62):
+				((sll) 1 << 62);
+			acc->lo = 0;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Variance of an array
+ */
+
+sll sllvarv(const sll *x, int n, int ddof)
+{
+	sll m;
+	sllacc acc;
+
+	if (n - ddof <= 0)
+		return CONST_0;
+
+	m = sllmeanv(x, n);
+	_sllcomoment(&acc, x, m, x, m, n, 0);
+
+	return _sllaccdivisat(&acc, n - ddof);
+}
+
+/*
+ * Covariance of two arrays
+ */
+
+sll sllcovv(const sll *x, const sll *y, int n, int ddof)
+{
+	sllacc acc;
+
+	if (n - ddof <= 0)
+		return CONST_0;
+
+	_sllcomoment(&acc, x, sllmeanv(x, n), y, sllmeanv(y, n), n, 0);
+
+	return _sllaccdivisat(&acc, n - ddof);
+}
+
+/*
+ * Pearson correlation of two arrays
+ *
+ * Description
+ *
+ *	r = sxy / (sxx^(1 / 2) * syy^(1 / 2))
+ *
+ *	where sxx, syy and sxy are the exact sums of products of deviations.
+ *	They may be far outside the range of sll, or far below its precision,
+ *	so sxx is scaled by 2^(-2 * a), syy by 2^(-2 * b) and sxy by 2^-(a + b),
+ *	which leaves r unchanged, with a and b chosen to give each about 62
+ *	significant bits.  Data too wide for the sums are scaled down by 2^s
+ *	first, with 2 * s more than the bits of n, which also leaves r
+ *	unchanged but for the bits shifted out.
+ */
+
+sll sllcorrv(const sll *x, const sll *y, int n)
+{
+	int a, b;
+	int s;
+	sll mx, my;
+	sll d;
+	sllacc sxx, syy, sxy;
+
+	mx = sllmeanv(x, n);
+	my = sllmeanv(y, n);
+	if (_sllcomoment(&sxx, x, mx, x, mx, n, 0) |
+			_sllcomoment(&syy, y, my, y, my, n, 0) |
+			_sllcomoment(&sxy, x, mx, y, my, n, 0)) {
+		/* Deviations under 2^(32 - s), so the sums under 2^62 */
+		s = (_sllbits((ull) n) + 4) >> 1;
+		_sllcomoment(&sxx, x, mx, x, mx, n, s);
+		_sllcomoment(&syy, y, my, y, my, n, s);
+		_sllcomoment(&sxy, x, mx, y, my, n, s);
+	}
+
+	/* Shifts to about 2^62 raw, and from 64.64 to 32.32 */
+	a = (_sllaccbits(&sxx) - 61) >> 1;
+	b = (_sllaccbits(&syy) - 61) >> 1;
+
+	d = sllmul(sllsqrt(_sllaccshift(&sxx, 2 * a + 32)),
+		sllsqrt(_sllaccshift(&syy, 2 * b + 32)));
+	if (d == CONST_0)
+		return CONST_0;
+
+	/* Rounding must not take it out of range */
+	return sllclamp(_sllratio(_sllaccshift(&sxy, a + b + 32), d),
+		_sllneg(CONST_1), CONST_1);
+}
+
+/*
+ * Minimum of an array
+ */
+
+sll sllminv(const sll *x, int n)
+{
+	if (n <= 0)
+		return CONST_0;
+
+	return x[sllargminv(x, n)];
+}
+
+/*
+ * Maximum of an array
+ */
+
+sll sllmaxv(const sll *x, int n)
+{
+	if (n <= 0)
+		return CONST_0;
+
+	return x[sllargmaxv(x, n)];
+}
+
+/*
+ * Index of the first minimum of an array
+ */
+
+int sllargminv(const sll *x, int n)
+{
+	int i;
+	int k;
+
+	for (k = 0, i = 1; i < n; i++)
+		if (x[i] < x[k])
+			k = i;
+
+	return k;
+}
+
+/*
+ * Index of the first maximum of an array
+ */
+
+int sllargmaxv(const sll *x, int n)
+{
+	int i;
+	int k;
+
+	for (k = 0, i = 1; i < n; i++)
+		if (x[i] > x[k])
+			k = i;
+
+	return k;
+}
+
+/*
+ * Ratio of two wide accumulators, the denominator positive
+ *
+ * Description
+ *
+ *	Both are shifted by the same amount, which leaves the ratio unchanged,
+ *	so that the larger has about 62 significant bits.
+ */
+
+static sll _sllaccratio(const sllacc *num, const sllacc *den)
+{
+	int s;
+	int b;
+	sllacc t;
+
+	t = *num;
+	if (t.hi < 0) {
+		t.lo = -t.lo;
+		t.hi = ~t.hi + (t.lo == 0);
+	}
+
+	s = _sllaccbits(den);
+	if ((b = _sllaccbits(&t)) > s)
+		s = b;
+	s -= 62;
+
+	return _sllratio(_sllaccshift(num, s), _sllaccshift(den, s));
+}
+
+/*
+ * x / y for y > 0, rounded to nearest
+ *
+ * Description
+ *
+ *	The chopped ratio q is raised by one where 2 * x - (2 * q + 1) * y,
+ *	taken exactly, is not negative, so a tiny quotient of either sign
+ *	rounds to 0 rather than to -2^-32.
+ */
+
+static sll _sllratioround(sll x, sll y)
+{
+	sll q;
+	sllacc a;
+
+	q = _sllratio(x, y);
+
+	sllacczero(&a);
+	sllaccadd(&a, x);
+	sllaccadd(&a, x);
+	sllaccmsub(&a, 2 * q + 1, y);
+
+	return (a.hi >= 0) ? q + 1: q;
+}
+
+/*
+ * Multiply a wide accumulator by a non-negative integer
+ */
+
+static void _sllaccmuli(sllacc *a, int n)
+{
+	ull p0, p1;
+	ull lo;
+
+	p0 = (a->lo & 0xffffffffULL) * (ull) n;
+	p1 = (a->lo >> 32) * (ull) n;
+	lo = p0 + (p1 << 32);
+
+	a->hi = a->hi * n + (sll) ((p1 >> 32) + (lo < p0));
+	a->lo = lo;
+}
+
+/*
+ * Fit a line to n samples
+ *
+ * Description
+ *
+ *	b = sxy / sxx
+ *	a = my - b * mx
+ *
+ *	where sxx and sxy are the exact sums of products of deviations.
+ */
+
+int sllfitline(sll *a, sll *b, const sll *x, const sll *y, int n)
+{
+	return sllfitlinev(a, b, x, y, n, 1);
+}
+
+/*
+ * Fit lines to m series sharing x
+ */
+
+int sllfitlinev(sll *a, sll *b, const sll *x, const sll *y, int n, int m)
+{
+	int j;
+	int s, t;
+	sll mx, my;
+	sllacc sxx, sxy, txx;
+
+	if (n < 2)
+		return 0;
+
+	/* Data too wide for the sums are scaled down, as in sllcorrv() */
+	t = (_sllbits((ull) n) + 4) >> 1;
+	mx = sllmeanv(x, n);
+	s = _sllcomoment(&sxx, x, mx, x, mx, n, 0) ? t: 0;
+	if (s)
+		_sllcomoment(&sxx, x, mx, x, mx, n, s);
+	if (sxx.hi == 0 && sxx.lo == 0)
+		return 0;
+
+	for (j = 0; j < m; j++, y += n) {
+		my = sllmeanv(y, n);
+		if (_sllcomoment(&sxy, x, mx, y, my, n, s)) {
+			_sllcomoment(&sxy, x, mx, y, my, n, t);
+			_sllcomoment(&txx, x, mx, x, mx, n, t);
+			b[j] = _sllaccratio(&sxy, &txx);
+		} else {
+			b[j] = _sllaccratio(&sxy, &sxx);
+		}
+		a[j] = _sllsub(my, sllmul(b[j], mx));
+	}
+
+	return 1;
+}
+
+/*
+ * Fit a polynomial of degree deg to n samples
+ */
+
+int sllfitpoly(sll *c, const sll *x, const sll *y, int n, int deg)
+{
+	return sllfitpolyv(c, x, y, n, deg, 1);
+}
+
+/*
+ * Fit polynomials to m series sharing x
+ *
+ * Description
+ *
+ *	With t = (x - mx) / s in [-1, 1], the normal equations are
+ *
+ *	SUM[k] M[j + k] * d[k] = R[j],  M[p] = SUM t^p / n,
+ *	R[j] = SUM t^j * y / n
+ *
+ *	M is the same for every series, so it is decomposed once, and the
+ *	right hand sides are solved together.  Then e[j] = d[j] / s^j, taken
+ *	as j rounded divisions by s, so s^j never has to fit, and noise in
+ *	d[j] rounds to 0 rather than being magnified, and the Taylor shift of
+ *	SUM e[j] * (x - mx)^j gives c.  Returns 0 if a coefficient does not
+ *	fit in sll.
+ */
+
+int sllfitpolyv(sll *c, const sll *x, const sll *y, int n, int deg, int m)
+{
+	int i, j, k, p;
+	int q;
+	sll mx;
+	sll s;
+	sll t;
+	sll tp[2 * SLLFIT_MAX];
+	sll g[SLLFIT_MAX * SLLFIT_MAX];
+	sll l[SLLFIT_MAX * SLLFIT_MAX];
+	sllacc acc[2 * SLLFIT_MAX];
+
+	q = deg + 1;
+	if (deg < 0 || q > SLLFIT_MAX || n < q)
+		return 0;
+
+	/* The mapping onto [-1, 1] */
+	mx = sllmeanv(x, n);
+	for (s = CONST_0, i = 0; i < n; i++)
+		if ((t = _sllabs(_sllsub(x[i], mx))) > s)
+			s = t;
+	/* All x the same determine only a constant */
+	if (s == CONST_0)
+		s = CONST_1;
+
+	/* The moments, M[p] = SUM t^(p / 2) * t^(p - p / 2) */
+	for (p = 0; p < 2 * q - 1; p++)
+		sllacczero(&acc[p]);
+	for (i = 0; i < n; i++) {
+		t = _sllratio(_sllsub(x[i], mx), s);
+		for (tp[0] = CONST_1, k = 1; k < 2 * q - 1; k++)
+			tp[k] = sllmul(tp[k - 1], t);
+		for (p = 0; p < 2 * q - 1; p++)
+			sllaccmac(&acc[p], tp[p >> 1], tp[p - (p >> 1)]);
+	}
+	for (j = 0; j < q; j++)
+		for (k = 0; k < q; k++)
+			g[j * q + k] = sllaccdivi(&acc[j + k], n);
+	if (!sllcholesky(l, g, q))
+		return 0;
+
+	for (; m > 0; m--, y += n, c += q) {
+		/* The right hand side */
+		for (j = 0; j < q; j++)
+			sllacczero(&acc[j]);
+		for (i = 0; i < n; i++) {
+			t = _sllratio(_sllsub(x[i], mx), s);
+			for (tp[0] = CONST_1, k = 1; k < q; k++)
+				tp[k] = sllmul(tp[k - 1], t);
+			for (j = 0; j < q; j++)
+				sllaccmac(&acc[j], tp[j], y[i]);
+		}
+		for (j = 0; j < q; j++)
+			c[j] = sllaccdivi(&acc[j], n);
+		sllcholsolve(c, l, c, q, 1);
+
+		/* Back from t to x - mx, dividing by s j times */
+		for (j = 1; j < q; j++)
+			for (k = 0; k < j; k++) {
+				if (s < CONST_1 && _sllabs(c[j]) >=
+						sllmul(CONST_MAX, s))
+					return 0;
+				c[j] = _sllratioround(c[j], s);
+			}
+
+		/* Taylor shift by -mx */
+		for (i = 0; i < deg; i++)
+			for (j = deg - 1; j >= i; j--) {
+				sllacczero(&acc[0]);
+				sllaccadd(&acc[0], c[j]);
+				sllaccmac(&acc[0], _sllneg(mx), c[j + 1]);
+				if (acc[0].hi < -0x80000000LL ||
+						acc[0].hi > 0x7fffffffLL)
+					return 0;
+				c[j] = sllacc2sll(&acc[0]);
+			}
+	}
+
+	return 1;
+}
+
+/*
+ * Prepare a streaming line fit
+ */
+
+void sllfitinit(sllfit *f)
+{
+	f->n = 0;
+	f->x0 = CONST_0;
+	f->y0 = CONST_0;
+	sllacczero(&f->sx);
+	sllacczero(&f->sy);
+	sllacczero(&f->sxx);
+	sllacczero(&f->sxy);
+}
+
+/*
+ * Add a sample to a streaming line fit
+ */
+
+void sllfitadd(sllfit *f, sll x, sll y)
+{
+	if (f->n++ == 0) {
+		f->x0 = x;
+		f->y0 = y;
+	}
+
+	x = _sllsub(x, f->x0);
+	y = _sllsub(y, f->y0);
+	sllaccadd(&f->sx, x);
+	sllaccadd(&f->sy, y);
+	sllaccmac(&f->sxx, x, x);
+	sllaccmac(&f->sxy, x, y);
+}
+
+/*
+ * Remove a sample from a streaming line fit
+ */
+
+void sllfitremove(sllfit *f, sll x, sll y)
+{
+	f->n--;
+
+	x = _sllsub(x, f->x0);
+	y = _sllsub(y, f->y0);
+	sllaccadd(&f->sx, _sllneg(x));
+	sllaccadd(&f->sy, _sllneg(y));
+	sllaccmsub(&f->sxx, x, x);
+	sllaccmsub(&f->sxy, x, y);
+}
+
+/*
+ * Line of a streaming fit
+ *
+ * Description
+ *
+ *	b = (n * sxy - sx * sy) / (n * sxx - sx^2)
+ *	a = y0 + sy / n - b * (x0 + sx / n)
+ *
+ *	Both differences are exact, given that sx and sy are in range.
+ */
+
+int sllfitget(const sllfit *f, sll *a, sll *b)
+{
+	sll sx, sy;
+	sllacc dxx, dxy;
+
+	if (f->n < 2)
+		return 0;
+
+	sx = sllacc2sll(&f->sx);
+	sy = sllacc2sll(&f->sy);
+
+	dxx = f->sxx;
+	_sllaccmuli(&dxx, f->n);
+	sllaccmsub(&dxx, sx, sx);
+	if (dxx.hi < 0 || (dxx.hi == 0 && dxx.lo == 0))
+		return 0;
+
+	dxy = f->sxy;
+	_sllaccmuli(&dxy, f->n);
+	sllaccmsub(&dxy, sx, sy);
+
+	*b = _sllaccratio(&dxy, &dxx);
+	*a = _sllsub(_slladd(f->y0, sllaccdivi(&f->sy, f->n)),
+		sllmul(*b, _slladd(f->x0, sllaccdivi(&f->sx, f->n))));
+
+	return 1;
+}
+
+/*
+ * Prepare a moving average
+ */
+
+void sllsmainit(sllsma *s, sll *buf, int size)
+{
+	s->buf = buf;
+	s->size = size;
+	s->pos = 0;
+	s->count = 0;
+	sllacczero(&s->sum);
+}
+
+/*
+ * Moving average, one sample
+ */
+
+sll sllsmastep(sllsma *s, sll x)
+{
+	if (s->count == s->size)
+		sllaccadd(&s->sum, _sllneg(s->buf[s->pos]));
+	else
+		s->count++;
+
+	sllaccadd(&s->sum, x);
+	s->buf[s->pos] = x;
+	if (++s->pos == s->size)
+		s->pos = 0;
+
+	return sllaccdivi(&s->sum, s->count);
+}
+
+/*
+ * Prepare moving averages of many series
+ */
+
+void sllsmabankinit(sllsmabank *b, sll *buf, sllacc *sum, int n, int size)
+{
+	int i;
+
+	b->n = n;
+	b->size = size;
+	b->pos = 0;
+	b->count = 0;
+	b->buf = buf;
+	b->sum = sum;
+
+	for (i = 0; i < n; i++)
+		sllacczero(&sum[i]);
+}
+
+/*
+ * Moving averages of many series, one sample of each
+ *
+ * Description
+ *
+ *	All series tick together, so they share the ring position, and each
+ *	row of the buffer is one tick of every series.
+ */
+
+void sllsmabankstep(sllsmabank *b, sll *mean, const sll *x)
+{
+	int i;
+	int full;
+	sll *row;
+
+	row = &b->buf[b->pos * b->n];
+
+	if (!(full = b->count == b->size))
+		b->count++;
+
+	for (i = 0; i < b->n; i++) {
+		if (full)
+			sllaccadd(&b->sum[i], _sllneg(row[i]));
+		sllaccadd(&b->sum[i], x[i]);
+		row[i] = x[i];
+		mean[i] = sllaccdivi(&b->sum[i], b->count);
+	}
+
+	if (++b->pos == b->size)
+		b->pos = 0;
+}
+
+/*
+ * Prepare an exponential moving average
+ *
+ * Description
+ *
+ *	Detects alpha = 2^-k, for which the update is a shift.
+ */
+
+void sllemainit(sllema *e, sll alpha)
+{
+	int k;
+
+	e->y = CONST_0;
+	e->alpha = alpha;
+	e->primed = 0;
+
+	e->shift = -1;
+	for (k = 0; k < 32; k++)
+		if (alpha == (CONST_1 >> k))
+			e->shift = k;
+}
+
+/*
+ * Exponential moving average, one sample
+ *
+ * Description
+ *
+ *	y = y + alpha * (x - y)
+ *
+ *	The first sample sets y.
+ */
+
+sll sllemastep(sllema *e, sll x)
+{
+	if (!e->primed) {
+		e->primed = 1;
+		e->y = x;
+	} else if (e->shift >= 0) {
+		e->y = _slladd(e->y, slldiv2n(_sllsub(x, e->y), e->shift));
+	} else {
+		e->y = sllfma(e->alpha, _sllsub(x, e->y), e->y);
+	}
+
+	return e->y;
+}
+
+/*
+ * Exponential moving averages of many series, one sample of each
+ */
+
+void sllemastepv(sll *y, const sll *x, sll alpha, int n)
+{
+	int i;
+	sllema e;
+
+	sllemainit(&e, alpha);
+	e.primed = 1;
+
+	for (i = 0; i < n; i++) {
+		e.y = y[i];
+		y[i] = sllemastep(&e, x[i]);
+	}
+}
+
+/*
+ * Prepare a rolling variance
+ */
+
+void sllrvarinit(sllrvar *v, sll *buf, int size, int ddof)
+{
+	v->buf = buf;
+	v->size = size;
+	v->pos = 0;
+	v->count = 0;
+	v->ddof = ddof;
+	v->ref = CONST_0;
+	sllacczero(&v->s1);
+	sllacczero(&v->s2);
+}
+
+/*
+ * Rolling variance, one sample
+ *
+ * Description
+ *
+ *	With d = x - ref over the window:
+ *
+ *	m = SUM d / n
+ *	var = (SUM d^2 / n - m^2) * n / (n - ddof)
+ *
+ *	Both sums are exact, so the only loss is the cancellation between
+ *	the two terms, which is small while ref is near the mean.  So each
+ *	time the buffer wraps, ref moves to the current mean and the sums
+ *	are rebuilt from the buffer, which is O(1) per sample on average.
+ */
+
+sll sllrvarstep(sllrvar *v, sll x)
+{
+	int i;
+	sll d;
+	sll m;
+	sll var;
+
+	if (v->count == 0)
+		v->ref = x;
+
+	if (v->count == v->size) {
+		d = _sllsub(v->buf[v->pos], v->ref);
+		sllaccadd(&v->s1, _sllneg(d));
+		sllaccmsub(&v->s2, d, d);
+	} else {
+		v->count++;
+	}
+
+	d = _sllsub(x, v->ref);
+	sllaccadd(&v->s1, d);
+	sllaccmac(&v->s2, d, d);
+	v->buf[v->pos] = x;
+
+	m = sllaccdivi(&v->s1, v->count);
+
+	if (++v->pos == v->size) {
+		v->pos = 0;
+
+		/* Recentre on the mean */
+		v->ref = _slladd(v->ref, m);
+		sllacczero(&v->s1);
+		sllacczero(&v->s2);
+		for (i = 0; i < v->count; i++) {
+			d = _sllsub(v->buf[i], v->ref);
+			sllaccadd(&v->s1, d);
+			sllaccmac(&v->s2, d, d);
+		}
+		m = sllaccdivi(&v->s1, v->count);
+	}
+
+	if (v->count - v->ddof <= 0)
+		return CONST_0;
+
+	var = _sllsub(sllaccdivi(&v->s2, v->count), sllmul(m, m));
+	if (var < CONST_0)
+		var = CONST_0;
+
+	if (v->ddof)
+		var = _sllratio(sllmul(var, int2sll(v->count)),
+			int2sll(v->count - v->ddof));
+
+	return var;
+}
+
+/*
+ * Prepare a rolling minimum or maximum
+ */
+
+void sllrollinit(sllroll *r, sll *val, unsigned *seq, int size, int ismax)
+{
+	r->val = val;
+	r->seq = seq;
+	r->size = size;
+	r->head = 0;
+	r->count = 0;
+	r->t = 0;
+	r->ismax = ismax;
+}
+
+/*
+ * Rolling minimum or maximum, one sample
+ *
+ * Description
+ *
+ *	The deque holds the samples that could still become the extreme, in
+ *	order of arrival, and so in order of value.  A new sample removes the
+ *	candidates at the back that it beats, since they leave the window
+ *	first, and the front leaves once it is size samples old.  Each sample
+ *	is pushed and popped at most once, so this is O(1) on average.
+ */
+
+sll sllrollstep(sllroll *r, sll x)
+{
+	int back;
+
+	/* Remove the candidates that x beats */
+	while (r->count) {
+		back = r->head + r->count - 1;
+		if (back >= r->size)
+			back -= r->size;
+		if (r->ismax ? (r->val[back] > x): (r->val[back] < x))
+			break;
+		r->count--;
+	}
+
+	/* Remove the front if it has left the window */
+	if (r->count && r->t - r->seq[r->head] >= (unsigned) r->size) {
+		if (++r->head == r->size)
+			r->head = 0;
+		r->count--;
+	}
+
+	back = r->head + r->count;
+	if (back >= r->size)
+		back -= r->size;
+	r->val[back] = x;
+	r->seq[back] = r->t++;
+	r->count++;
+
+	return r->val[r->head];
+}
+
+/*
+ * Number of significant bits
+ */
+
+static int _sllbits(ull u)
+{
+	int n;
+
+	n = 0;
+	if (u >> 32) {
+		n += 32;
+		u >>= 32;
+	}
+	if (u >> 16) {
+		n += 16;
+		u >>= 16;
+	}
+	if (u >> 8) {
+		n += 8;
+		u >>= 8;
+	}
+	if (u >> 4) {
+		n += 4;
+		u >>= 4;
+	}
+	if (u >> 2) {
+		n += 2;
+		u >>= 2;
+	}
+
+	return n + (int) ((u >> 1) ? 2: u);
+}
+
+/*
+ * Prepare a histogram of uniform bins
+ *
+ * Description
+ *
+ *	For hi <= lo there are no bins to divide by, so hi is taken as lo and
+ *	every sample is under or over.  The width w = hi - lo is unsigned, so
+ *	ranges wider than 2^31 don't wrap.  For nbins < w, 2^64 * nbins / w
+ *	is found by long division, one bit at a time, with the remainder
+ *	kept below w.
+ */
+
+void sllhistinit(sllhist *h, unsigned *count, int nbins, sll lo, sll hi)
+{
+	int i;
+	int c;
+	ull q, r, w;
+
+	h->lo = lo;
+	h->hi = (hi > lo) ? hi: lo;
+	h->scale = CONST_0;
+	h->recip = 0;
+
+	w = (ull) h->hi - (ull) lo;
+	if ((ull) nbins < w) {
+		for (q = 0, r = (ull) nbins, i = 0; i < 64; i++) {
+			c = (int) (r >> 63);
+			r <<= 1;
+			q <<= 1;
+			if (c || r >= w) {
+				r -= w;
+				q |= 1;
+			}
+		}
+		h->recip = q;
+	}
+
+	h->nbins = nbins;
+	h->per_octave = 0;
+	h->count = count;
+	sllhistclear(h);
+}
+
+/*
+ * Prepare a histogram of log-scale bins
+ *
+ * Description
+ *
+ *	Bin i covers [lo * 2^(i / per_octave), lo * 2^((i + 1) / per_octave)).
+ */
+
+void sllhistloginit(sllhist *h, unsigned *count, int nbins, sll lo,
+	int per_octave)
+{
+	h->lo = lo;
+	h->hi = CONST_MAX;
+	h->scale = slllog2(lo);
+	h->recip = 0;
+	h->nbins = nbins;
+	h->per_octave = per_octave;
+	h->count = count;
+	sllhistclear(h);
+}
+
+/*
+ * Zero the counts of a histogram
+ */
+
+void sllhistclear(sllhist *h)
+{
+	int i;
+
+	for (i = 0; i < h->nbins; i++)
+		h->count[i] = 0;
+	h->under = 0;
+	h->over = 0;
+}
+
+/*
+ * Bin of a sample
+ *
+ * Description
+ *
+ *	Returns -1 below the bins and nbins above them.  A uniform bin is
+ *	floor(d * nbins / w), for d = x - lo and w = hi - lo, both unsigned.
+ *	The reciprocal is chopped, so d times it may be one bin low, and one
+ *	exact comparison with the next bin edge corrects it.  With no more
+ *	than a bin for each ulp, d and w are under 2^31, and the division is
+ *	done directly.
+ */
+
+int sllhistbin(const sllhist *h, sll x)
+{
+	sll d;
+	int i;
+	ull u, w;
+	ull ahi, alo;
+	ull bhi, blo;
+
+	if (x < h->lo)
+		return -1;
+
+	if (h->per_octave) {
+		d = _sllsub(slllog2(x), h->scale);
+		if (d >= int2sll(h->nbins) / h->per_octave + CONST_1)
+			return h->nbins;
+		i = _sll2int(d * h->per_octave);
+	} else {
+		if (x >= h->hi)
+			return h->nbins;
+		u = (ull) x - (ull) h->lo;
+		w = (ull) h->hi - (ull) h->lo;
+		if (!h->recip)
+			return (int) (u * (unsigned) h->nbins / w);
+
+		_sllumul128(u, h->recip, &bhi, &blo);
+		i = (int) bhi;
+
+		/* Up one if the next edge, (i + 1) * w, is at most u * nbins */
+		_sllumul128(u, (unsigned) h->nbins, &ahi, &alo);
+		_sllumul128((ull) i + 1, w, &bhi, &blo);
+		if (bhi < ahi || (bhi == ahi && blo <= alo))
+			i++;
+	}
+
+	return i < h->nbins ? i: h->nbins;
+}
+
+/*
+ * Bins of an array of samples
+ */
+
+void sllhistbinv(const sllhist *h, int *bin, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		bin[i] = sllhistbin(h, x[i]);
+}
+
+/*
+ * Count an array of samples
+ */
+
+void sllhistaddv(sllhist *h, const sll *x, int n)
+{
+	int i;
+	int b;
+
+	for (i = 0; i < n; i++) {
+		b = sllhistbin(h, x[i]);
+		if (b < 0)
+			h->under++;
+		else if (b == h->nbins)
+			h->over++;
+		else
+			h->count[b]++;
+	}
+}
+
+/*
+ * Add the counts of a histogram with the same bins
+ */
+
+void sllhistmerge(sllhist *h, const sllhist *o)
+{
+	int i;
+
+	for (i = 0; i < h->nbins; i++)
+		h->count[i] += o->count[i];
+	h->under += o->under;
+	h->over += o->over;
+}
+
+/*
+ * Absolute value
+ */
+
+static __inline__ sll _sllabs(sll x)
+{
+	return ((x < CONST_0) ? _sllneg(x): x);
+}
+
+/*
+ * Root by Brent's method
+ *
+ * Description
+ *
+ *	Inverse quadratic interpolation or the secant method when they make
+ *	good progress, bisection when they don't, always keeping the root
+ *	bracketed by b and c, with b the best estimate.
+ *
+ *	In floating point the tolerance grows with |b|, but the sll grid is
+ *	uniform, so it is simply tol / 2, and never less than one step of
+ *	the grid.  No ratio uses slldiv(), which is imprecise for large
+ *	divisors.
+ *
+ *	Interpolation is only tried with |fa| > |fb|, and inverse quadratic
+ *	interpolation only with |fc| >= |fa|, so that every ratio of the f
+ *	values is at most 1 in magnitude.  With the bracket, the last step
+ *	and b - a also under 2^26, p and q and the tests on them can't
+ *	overflow.  Otherwise, bisection is used.
+ */
+
+sll sllbrent(sllfn f, void *ctx, sll a, sll b, sll tol, int maxit)
+{
+	sll c, d, e;
+	sll fa, fb, fc;
+	sll tol1;
+	sll xm;
+	sll p, q, r, s;
+	sll t;
+	sll lim;
+
+	fa = f(a, ctx);
+	fb = f(b, ctx);
+
+	tol1 = slldiv2(tol);
+	if (tol1 < 1)
+		tol1 = 1;
+	lim = int2sll(1 << 26);
+
+	c = a;
+	fc = fa;
+	d = e = _sllsub(b, a);
+
+	while (maxit-- > 0) {
+		/* Keep the root between b and c */
+		if ((fb > 0 && fc > 0) || (fb < 0 && fc < 0)) {
+			c = a;
+			fc = fa;
+			d = e = _sllsub(b, a);
+		}
+
+		/* Keep b the best estimate */
+		if (_sllabs(fc) < _sllabs(fb)) {
+			a = b;
+			b = c;
+			c = a;
+			fa = fb;
+			fb = fc;
+			fc = fa;
+		}
+
+		xm = slldiv2(_sllsub(c, b));
+		if (_sllabs(xm) <= tol1 || fb == CONST_0)
+			break;
+
+		if (_sllabs(e) >= tol1 && _sllabs(fa) > _sllabs(fb) &&
+				(a == c || _sllabs(fc) >= _sllabs(fa)) &&
+				_sllabs(e) < lim && _sllabs(xm) < lim &&
+				_sllabs(_sllsub(b, a)) < lim) {
+			s = _sllratio(fb, fa);
+			if (a == c) {
+				/* Secant */
+				p = sllmul(sllmul2(xm), s);
+				q = _sllsub(CONST_1, s);
+			} else {
+				/* Inverse quadratic interpolation */
+				q = _sllratio(fa, fc);
+				r = _sllratio(fb, fc);
+				p = sllmul(s, _sllsub(
+					sllmul(sllmul(sllmul2(xm), q), _sllsub(q, r)),
+					sllmul(_sllsub(b, a), _sllsub(r, CONST_1))));
+				q = sllmul(sllmul(_sllsub(q, CONST_1),
+					_sllsub(r, CONST_1)), _sllsub(s, CONST_1));
+			}
+			if (p > CONST_0)
+				q = _sllneg(q);
+			p = _sllabs(p);
+
+			/* Accept the interpolation if it stays well inside */
+			t = _sllsub(sllmul(sllmul(int2sll(3), xm), q),
+				_sllabs(sllmul(tol1, q)));
+			if (_sllabs(sllmul(e, q)) < t)
+				t = _sllabs(sllmul(e, q));
+			if (sllmul2(p) < t) {
+				e = d;
+				d = _sllratio(p, q);
+			} else {
+				d = xm;
+				e = d;
+			}
+		} else {
+			/* Bisection */
+			d = xm;
+			e = d;
+		}
+
+		a = b;
+		fa = fb;
+		if (_sllabs(d) > tol1)
+			b = _slladd(b, d);
+		else
+			b = (xm > 0) ? _slladd(b, tol1): _sllsub(b, tol1);
+		fb = f(b, ctx);
+	}
+
+	return b;
+}
+
+/*
+ * One step of the Illinois method
+ *
+ * Description
+ *
+ *	The secant through (a, f(a)) and (b, f(b)) crosses zero at:
+ *	x = b - f(b) * (b - a) / (f(b) - f(a))
+ *
+ *	Since f(a) and f(b) have opposite signs, the ratio
+ *	f(b) / (f(b) - f(a)) is between 0 and 1, so it can't overflow.
+ *
+ *	If f(x) has the opposite sign to f(b), b moves to a.  Otherwise a is
+ *	kept a second time, and f(a) is halved, which stops regula falsi from
+ *	stalling at one end.  Then x becomes the new b.
+ *
+ *	A step that is lost below the grid is forced to one step of the grid,
+ *	so the bracket always shrinks.
+ *
+ *	Returns 1 when done.
+ */
+
+static int _sllillinois(sll *a, sll *b, sll *fa, sll *fb, sll tol,
+	sll *x)
+{
+	sll w;
+
+	w = _sllsub(*b, *a);
+	if (*fb == CONST_0 || _sllabs(w) <= tol)
+		return 1;
+
+	*x = sllfma(_sllneg(_sllratio(*fb, _sllsub(*fb, *fa))), w, *b);
+	if (*x == *b)
+		*x = (w > 0) ? _sllsub(*b, 1): _slladd(*b, 1);
+
+	return 0;
+}
+
+static void _sllillinoisnext(sll *a, sll *b, sll *fa, sll *fb, sll x,
+	sll fx)
+{
+	if ((fx < 0) != (*fb < 0)) {
+		*a = *b;
+		*fa = *fb;
+	} else {
+		*fa = slldiv2(*fa);
+	}
+
+	*b = x;
+	*fb = fx;
+}
+
+/*
+ * Root by the Illinois method
+ */
+
+sll sllillinois(sllfn f, void *ctx, sll a, sll b, sll tol, int maxit)
+{
+	sll fa, fb;
+	sll x;
+
+	fa = f(a, ctx);
+	fb = f(b, ctx);
+
+	if (tol < 1)
+		tol = 1;
+
+	while (maxit-- > 0 && !_sllillinois(&a, &b, &fa, &fb, tol, &x))
+		_sllillinoisnext(&a, &b, &fa, &fb, x, f(x, ctx));
+
+	return b;
+}
+
+/*
+ * Many roots by the Illinois method
+ *
+ * Description
+ *
+ *	Each element is an independent problem, and all of them are stepped
+ *	together so that f is called once per iteration for the whole batch.
+ *	Elements that are done keep their value while the others finish.
+ */
+
+void sllillinoisv(sllfnv f, void *ctx, sll *x, sll *a, sll *b, int n,
+	sll tol, int maxit, sll *work)
+{
+	int i;
+	int done;
+	sll *fa;
+	sll *fb;
+	sll *fx;
+
+	fa = work;
+	fb = fa + n;
+	fx = fb + n;
+
+	if (tol < 1)
+		tol = 1;
+
+	f(fa, a, n, ctx);
+	f(fb, b, n, ctx);
+
+	while (maxit-- > 0) {
+		done = 1;
+		for (i = 0; i < n; i++) {
+			if (_sllillinois(&a[i], &b[i], &fa[i], &fb[i], tol, &x[i]))
+				x[i] = b[i];
+			else
+				done = 0;
+		}
+		if (done)
+			break;
+
+		/* x holds b for done elements, which leaves them done */
+		f(fx, x, n, ctx);
+		for (i = 0; i < n; i++)
+			_sllillinoisnext(&a[i], &b[i], &fa[i], &fb[i], x[i], fx[i]);
+	}
+
+	for (i = 0; i < n; i++)
+		x[i] = b[i];
+}
+
+/*
+ * Root by Newton's method
+ *
+ * Description
+ *
+ *	x = x - f(x) / f'(x)
+ *
+ *	Stops when the step is within tol, or if f'(x) is 0.
+ */
+
+sll sllnewton(sllfn f, sllfn df, void *ctx, sll x, sll tol, int maxit)
+{
+	sll d;
+	sll dx;
+
+	while (maxit-- > 0) {
+		d = df(x, ctx);
+		if (d == CONST_0)
+			break;
+
+		dx = _sllratio(f(x, ctx), d);
+		x = _sllsub(x, dx);
+
+		if (_sllabs(dx) <= tol)
+			break;
+	}
+
+	return x;
+}
+
+/*
+ * Minimum by golden-section search
+ *
+ * Description
+ *
+ *	Keep two interior points dividing [a, b] in the golden ratio, and
+ *	discard the end beyond the worse one.  The surviving interior point
+ *	is in the right place for the next iteration, so each iteration costs
+ *	one evaluation and shrinks the interval by 1 / phi.
+ */
+
+sll sllgolden(sllfn f, void *ctx, sll a, sll b, sll tol, int maxit)
+{
+	sll c, d;
+	sll fc, fd;
+
+	if (tol < 1)
+		tol = 1;
+
+	c = _sllsub(b, sllmul(_sllsub(b, a), CONST_1_PHI));
+	d = _slladd(a, sllmul(_sllsub(b, a), CONST_1_PHI));
+	fc = f(c, ctx);
+	fd = f(d, ctx);
+
+	while (maxit-- > 0 && _sllsub(b, a) > tol) {
+		if (fc < fd) {
+			b = d;
+			d = c;
+			fd = fc;
+			c = _sllsub(b, sllmul(_sllsub(b, a), CONST_1_PHI));
+			fc = f(c, ctx);
+		} else {
+			a = c;
+			c = d;
+			fc = fd;
+			d = _slladd(a, sllmul(_sllsub(b, a), CONST_1_PHI));
+			fd = f(d, ctx);
+		}
+	}
+
+	return _slladd(a, slldiv2(_sllsub(b, a)));
+}
+
+/*
+ * Classic fourth order Runge-Kutta step
+ *
+ * Description
+ *
+ *	k1 = f(t, y)
+ *	k2 = f(t + h / 2, y + h / 2 * k1)
+ *	k3 = f(t + h / 2, y + h / 2 * k2)
+ *	k4 = f(t + h, y + h * k3)
+ *	y = y + h / 6 * (k1 + 2 * k2 + 2 * k3 + k4)
+ *
+ *	The final sum is accumulated exactly as 6 * y + h * (...), then
+ *	divided by 6, so the step chops once and h / 6 is never rounded.
+ */
+
+void sllrk4(sllodefn f, void *ctx, sll *y, sll t, sll h, int n, sll *work)
+{
+	int i;
+	sll h2;
+	sll *k1, *k2, *k3, *k4;
+	sll *yt;
+	sllacc acc;
+
+	k1 = work;
+	k2 = k1 + n;
+	k3 = k2 + n;
+	k4 = k3 + n;
+	yt = k4 + n;
+
+	h2 = slldiv2(h);
+
+	f(k1, t, y, n, ctx);
+	for (i = 0; i < n; i++)
+		yt[i] = sllfma(h2, k1[i], y[i]);
+
+	f(k2, _slladd(t, h2), yt, n, ctx);
+	for (i = 0; i < n; i++)
+		yt[i] = sllfma(h2, k2[i], y[i]);
+
+	f(k3, _slladd(t, h2), yt, n, ctx);
+	for (i = 0; i < n; i++)
+		yt[i] = sllfma(h, k3[i], y[i]);
+
+	f(k4, _slladd(t, h), yt, n, ctx);
+	for (i = 0; i < n; i++) {
+		sllacczero(&acc);
+		sllaccmac(&acc, y[i], int2sll(6));
+		sllaccmac(&acc, h, k1[i]);
+		sllaccmac(&acc, sllmul2(h), k2[i]);
+		sllaccmac(&acc, sllmul2(h), k3[i]);
+		sllaccmac(&acc, h, k4[i]);
+		y[i] = sllaccdivi(&acc, 6);
+	}
+}
+
+/*
+ * Semi-implicit Euler step
+ *
+ * Description
+ *
+ *	v = v + h * a(x)
+ *	x = x + h * v
+ *
+ *	Using the new velocity for the position makes this symplectic, so
+ *	energy stays bounded, unlike the explicit Euler method.
+ */
+
+void sllsieuler(sllaccelfn a, void *ctx, sll *x, sll *v, sll h, int n,
+	sll *work)
+{
+	int i;
+
+	a(work, x, n, ctx);
+
+	for (i = 0; i < n; i++) {
+		v[i] = sllfma(h, work[i], v[i]);
+		x[i] = sllfma(h, v[i], x[i]);
+	}
+}
+
+/*
+ * Velocity Verlet step
+ *
+ * Description
+ *
+ *	x = x + h * (v + h / 2 * a)
+ *	a' = a(x)
+ *	v = v + h / 2 * (a + a')
+ *
+ *	Factoring h out of the position update avoids forming h^2, which has
+ *	few significant bits for small h.  The velocity update is applied as
+ *	two half kicks, before and after a' is known, so no copy of a is
+ *	needed.
+ */
+
+void sllverlet(sllaccelfn a, void *ctx, sll *x, sll *v, sll *acc, sll h,
+	int n)
+{
+	int i;
+	sll h2;
+
+	h2 = slldiv2(h);
+
+	for (i = 0; i < n; i++) {
+		x[i] = sllfma(h, sllfma(h2, acc[i], v[i]), x[i]);
+
+		/* First half kick, with the old acceleration */
+		v[i] = sllfma(h2, acc[i], v[i]);
+	}
+
+	a(acc, x, n, ctx);
+
+	for (i = 0; i < n; i++)
+		v[i] = sllfma(h2, acc[i], v[i]);
+}
+
+/*
+ * Linear system dy/dt = A * y, for use as an sllodefn
+ */
+
+void sllodelin(sll *dydt, sll t, const sll *y, int n, void *ctx)
+{
+	(void) t;
+
+	sllmatmul(dydt, (const sll *) ctx, y, n, n, 1);
+}
+
+/*
+ * Trapezoid rule over uniformly spaced samples
+ *
+ * Description
+ *
+ *	h * (y[0] / 2 + y[1] + ... + y[n - 2] + y[n - 1] / 2)
+ *
+ *	Accumulated as h * (y[0] + 2 * y[1] + ... + y[n - 1]), then halved.
+ */
+
+sll slltrapz(const sll *y, int n, sll h)
+{
+	int i;
+	sll h2;
+	sllacc acc;
+
+	if (n < 2)
+		return CONST_0;
+
+	h2 = sllmul2(h);
+
+	sllacczero(&acc);
+	sllaccmac(&acc, h, y[0]);
+	for (i = 1; i < n - 1; i++)
+		sllaccmac(&acc, h2, y[i]);
+	sllaccmac(&acc, h, y[n - 1]);
+
+	return sllaccdivi(&acc, 2);
+}
+
+/*
+ * Trapezoid rule over samples at any spacing
+ *
+ * Description
+ *
+ *	SUM[i=1,n) (x[i] - x[i - 1]) * (y[i] + y[i - 1]) / 2
+ */
+
+sll slltrapzx(const sll *x, const sll *y, int n)
+{
+	int i;
+	sllacc acc;
+
+	sllacczero(&acc);
+	for (i = 1; i < n; i++)
+		sllaccmac(&acc, _sllsub(x[i], x[i - 1]), _slladd(y[i], y[i - 1]));
+
+	return sllaccdivi(&acc, 2);
+}
+
+/*
+ * Simpson's rule over uniformly spaced samples
+ *
+ * Description
+ *
+ *	Simpson's rule needs an even number of intervals, n odd:
+ *	h / 3 * (y[0] + 4 * y[1] + 2 * y[2] + ... + 4 * y[n - 2] + y[n - 1])
+ *
+ *	When n is even, the last three intervals use Simpson's 3/8 rule:
+ *	3 * h / 8 * (y[0] + 3 * y[1] + 3 * y[2] + y[3])
+ *
+ *	Both are accumulated over the common denominator 24 and divided once.
+ *	Fewer than 3 samples fall back to the trapezoid rule.
+ */
+
+sll sllsimps(const sll *y, int n, sll h)
+{
+	int i;
+	int m;
+	sllacc acc;
+
+	if (n < 3)
+		return slltrapz(y, n, h);
+
+	/* Samples covered by Simpson's rule */
+	m = (n & 1) ? n: n - 3;
+
+	/* Weights times 24, applied to h, which is exact */
+	sllacczero(&acc);
+	if (m >= 3) {
+		sllaccmac(&acc, 8 * h, y[0]);
+		for (i = 1; i < m - 1; i++)
+			sllaccmac(&acc, ((i & 1) ? 32: 16) * h, y[i]);
+		sllaccmac(&acc, 8 * h, y[m - 1]);
+	}
+	if (m != n) {
+		sllaccmac(&acc, 9 * h, y[n - 4]);
+		sllaccmac(&acc, 27 * h, y[n - 3]);
+		sllaccmac(&acc, 27 * h, y[n - 2]);
+		sllaccmac(&acc, 9 * h, y[n - 1]);
+	}
+
+	return sllaccdivi(&acc, 24);
+}
+
+/*
+ * Gauss-Legendre quadrature, 5 points on each of m panels
+ *
+ * Description
+ *
+ *	On [-1, 1], exact for polynomials up to degree 9:
+ *	SUM w[i] * f(t[i])
+ *
+ *	Each panel [c - r, c + r] maps t to c + r * t and scales by r.  The
+ *	panel width is an integer division of the raw value, which is exact
+ *	to the last bit.
+ */
+
+static const sll _sllgauss_t[3] = {
+	0x0000000000000000LL,	// 0
+	0x0000000089d91fedLL,	// 0.5384693101056831
+	0x00000000e7fb6703LL	// 0.9061798459386640
+};
+
+static const sll _sllgauss_w[3] = {
+	0x0000000091a2b3c5LL,	// 0.5688888888888889
+	0x000000007a876897LL,	// 0.4786286704993665
+	0x000000003ca73d87LL	// 0.2369268850561891
+};
+
+sll sllgauss(sllfn f, void *ctx, sll a, sll b, int m)
+{
+	int i, j;
+	sll c;
+	sll r;
+	sll t;
+	sllacc acc;
+	sllacc panel;
+
+	r = slldiv2((b - a) / m);
+
+	sllacczero(&acc);
+	for (j = 0; j < m; j++) {
+		c = _slladd(a, (sll) (2 * j + 1) * r);
+
+		sllacczero(&panel);
+		sllaccmac(&panel, _sllgauss_w[0], f(c, ctx));
+		for (i = 1; i < 3; i++) {
+			t = sllmul(r, _sllgauss_t[i]);
+			sllaccmac(&panel, _sllgauss_w[i], f(_sllsub(c, t), ctx));
+			sllaccmac(&panel, _sllgauss_w[i], f(_slladd(c, t), ctx));
+		}
+		sllaccmac(&acc, r, sllacc2sll(&panel));
+	}
+
+	return sllacc2sll(&acc);
+}
+
+/*
+ * Adaptive Simpson's rule, one level
+ *
+ * Description
+ *
+ *	Compare the Simpson estimate s of [a, b] against the sum of the two
+ *	halves.  If they agree to 15 * eps, accept with Richardson's
+ *	correction, otherwise recurse on each half with eps / 2.
+ */
+
+static sll _sllasimps(sllfn f, void *ctx, sll a, sll b, sll fa, sll fm,
+	sll fb, sll s, sll eps, int depth)
+{
+	sll m, lm, rm;
+	sll flm, frm;
+	sll h;
+	sll sl, sr;
+	sll d;
+	sllacc acc;
+
+	m = _slladd(a, slldiv2(_sllsub(b, a)));
+	lm = _slladd(a, slldiv2(_sllsub(m, a)));
+	rm = _slladd(m, slldiv2(_sllsub(b, m)));
+	flm = f(lm, ctx);
+	frm = f(rm, ctx);
+
+	/* h / 6 * (fa + 4 * fm + fb), with h each half's width */
+	h = _sllsub(m, a);
+	sllacczero(&acc);
+	sllaccmac(&acc, h, _slladd(_slladd(fa, sllmul4(flm)), fm));
+	sl = sllaccdivi(&acc, 6);
+	h = _sllsub(b, m);
+	sllacczero(&acc);
+	sllaccmac(&acc, h, _slladd(_slladd(fm, sllmul4(frm)), fb));
+	sr = sllaccdivi(&acc, 6);
+
+	d = _sllsub(_slladd(sl, sr), s);
+	if (depth <= 0 || (d < 0 ? _sllneg(d): d) <= sllmul(int2sll(15), eps))
+		return _slladd(_slladd(sl, sr), d / 15);
+
+	eps = slldiv2(eps);
+	return _slladd(
+		_sllasimps(f, ctx, a, m, fa, flm, fm, sl, eps, depth - 1),
+		_sllasimps(f, ctx, m, b, fm, frm, fb, sr, eps, depth - 1));
+}
+
+/*
+ * Adaptive Simpson's rule
+ */
+
+sll sllasimps(sllfn f, void *ctx, sll a, sll b, sll eps, int depth)
+{
+	sll fa, fm, fb;
+	sll m;
+	sllacc acc;
+
+	m = _slladd(a, slldiv2(_sllsub(b, a)));
+	fa = f(a, ctx);
+	fm = f(m, ctx);
+	fb = f(b, ctx);
+
+	sllacczero(&acc);
+	sllaccmac(&acc, _sllsub(b, a), _slladd(_slladd(fa, sllmul4(fm)), fb));
+
+	return _sllasimps(f, ctx, a, b, fa, fm, fb, sllaccdivi(&acc, 6), eps,
+		depth);
+}
+
+/*
+ * Slope of the cubic spline through the knots
+ *
+ * Description
+ *
+ *	With h[i] = x[i + 1] - x[i] and s[i] = (y[i + 1] - y[i]) / h[i],
+ *	continuity of the second derivative at each inner knot is
+ *
+ *	w * d[i - 1] + 2 * d[i] + (1 - w) * d[i + 1]
+ *		= 3 * (w * s[i - 1] + (1 - w) * s[i])
+ *
+ *	with w = h[i] / (h[i - 1] + h[i]).  A natural end is
+ *	2 * d[0] + d[1] = 3 * s[0], and likewise at the other end, while a
+ *	clamped end fixes d.  The tridiagonal system is diagonally dominant,
+ *	so it is solved by elimination without pivoting, keeping the
+ *	eliminated upper diagonal in work.
+ */
+
+static void _sllspline(sll *d, const sll *x, const sll *y, sll *work, int n,
+	int clamped, sll d0, sll d1)
+{
+	int i;
+	sll w;
+	sll a, b, c;
+	sll r;
+	sll s0, s1;
+
+	if (n < 2) {
+		if (n == 1)
+			d[0] = CONST_0;
+		return;
+	}
+
+	s1 = _sllratio(_sllsub(y[1], y[0]), _sllsub(x[1], x[0]));
+	for (i = 0; i < n; i++) {
+		if (i == 0) {
+			a = CONST_0;
+			b = clamped ? CONST_1: CONST_2;
+			c = clamped ? CONST_0: CONST_1;
+			r = clamped ? d0: sllmul(CONST_3, s1);
+		} else if (i == n - 1) {
+			a = clamped ? CONST_0: CONST_1;
+			b = clamped ? CONST_1: CONST_2;
+			c = CONST_0;
+			r = clamped ? d1: sllmul(CONST_3, s1);
+		} else {
+			s0 = s1;
+			s1 = _sllratio(_sllsub(y[i + 1], y[i]),
+				_sllsub(x[i + 1], x[i]));
+			w = _sllratio(_sllsub(x[i + 1], x[i]),
+				_sllsub(x[i + 1], x[i - 1]));
+			a = w;
+			b = CONST_2;
+			c = _sllsub(CONST_1, w);
+			r = sllmul(CONST_3, _slladd(sllmul(w, s0),
+				sllmul(c, s1)));
+		}
+
+		/* Eliminate the lower diagonal */
+		if (i > 0) {
+			b = _sllsub(b, sllmul(a, work[i - 1]));
+			r = _sllsub(r, sllmul(a, d[i - 1]));
+		}
+		work[i] = _sllratio(c, b);
+		d[i] = _sllratio(r, b);
+	}
+
+	for (i = n - 2; i >= 0; i--)
+		d[i] = _sllsub(d[i], sllmul(work[i], d[i + 1]));
+}
+
+/*
+ * Natural cubic spline
+ */
+
+void sllspline(sll *d, const sll *x, const sll *y, sll *work, int n)
+{
+	_sllspline(d, x, y, work, n, 0, CONST_0, CONST_0);
+}
+
+/*
+ * Clamped cubic spline
+ */
+
+void sllsplinec(sll *d, const sll *x, const sll *y, sll *work, int n, sll d0,
+	sll d1)
+{
+	_sllspline(d, x, y, work, n, 1, d0, d1);
+}
+
+/*
+ * End slope of a PCHIP
+ *
+ * Description
+ *
+ *	d = ((2 * h0 + h1) * s0 - h0 * s1) / (h0 + h1)
+ *
+ *	from the end interval h0, s0 and its neighbour h1, s1.  It is set to
+ *	0 if its sign differs from s0, and limited to 3 * s0 where the data
+ *	turn.
+ */
+
+static sll _sllpchipend(sll h0, sll h1, sll s0, sll s1)
+{
+	sll w;
+	sll d;
+
+	w = _sllratio(h0, _slladd(h0, h1));
+	d = _sllsub(_slladd(s0, sllmul(w, s0)), sllmul(w, s1));
+
+	if (d == CONST_0 || (d < CONST_0) != (s0 < CONST_0))
+		return CONST_0;
+	if ((s0 < CONST_0) != (s1 < CONST_0) &&
+			_sllabs(d) > _sllabs(sllmul(CONST_3, s0)))
+		return sllmul(CONST_3, s0);
+
+	return d;
+}
+
+/*
+ * Piecewise cubic Hermite interpolating polynomial
+ *
+ * Description
+ *
+ *	At an inner knot, where the slopes s0 and s1 either side have the same
+ *	sign, d is their weighted harmonic mean
+ *
+ *	d = s0 * s1 / (w0 * s1 + w1 * s0)
+ *
+ *	with w0 = (2 * h1 + h0) / (3 * (h0 + h1)) and w1 = 1 - w0, and 0
+ *	otherwise.  The ends take the three point estimate, limited to keep
+ *	the shape.  |s1 / (w0 * s1 + w1 * s0)| <= 3, so nothing overflows.
+ */
+
+void sllpchip(sll *d, const sll *x, const sll *y, int n)
+{
+	int i;
+	sll h0, h1;
+	sll s0, s1;
+	sll w;
+
+	if (n < 2) {
+		if (n == 1)
+			d[0] = CONST_0;
+		return;
+	}
+
+	h1 = _sllsub(x[1], x[0]);
+	s1 = _sllratio(_sllsub(y[1], y[0]), h1);
+	if (n == 2) {
+		d[0] = d[1] = s1;
+		return;
+	}
+
+	for (i = 1; i < n - 1; i++) {
+		h0 = h1;
+		s0 = s1;
+		h1 = _sllsub(x[i + 1], x[i]);
+		s1 = _sllratio(_sllsub(y[i + 1], y[i]), h1);
+
+		if (s0 == CONST_0 || s1 == CONST_0 || (s0 < CONST_0) != (s1 <
+				CONST_0)) {
+			d[i] = CONST_0;
+		} else {
+			w = _sllratio(_slladd(h1, _slladd(h1, h0)),
+				sllmul(CONST_3, _slladd(h0, h1)));
+			d[i] = sllmul(s0, _sllratio(s1, _slladd(sllmul(w, s1),
+				sllmul(_sllsub(CONST_1, w), s0))));
+		}
+
+		/* The three point estimates at the ends */
+		if (i == 1)
+			d[0] = _sllpchipend(h0, h1, s0, s1);
+		if (i == n - 2)
+			d[n - 1] = _sllpchipend(h1, h0, s1, s0);
+	}
+}
+
+/*
+ * Evaluate a cubic Hermite segment
+ *
+ * Description
+ *
+ *	With t in [0, 1] across the segment, dy = y1 - y0, and slopes scaled
+ *	to the segment, e0 = h * d0 and e1 = h * d1:
+ *
+ *	y = y0 + t * (e0 + t * ((3 * dy - 2 * e0 - e1) + t * (e0 + e1 - 2 * dy)))
+ */
+
+static sll _sllhermite(sll y0, sll y1, sll d0, sll d1, sll h, sll t)
+{
+	sll dy;
+	sll e0, e1;
+	sll c2, c3;
+
+	dy = _sllsub(y1, y0);
+	e0 = sllmul(h, d0);
+	e1 = sllmul(h, d1);
+	c2 = _sllsub(_sllsub(sllmul(CONST_3, dy), _slladd(e0, e0)), e1);
+	c3 = _sllsub(_slladd(e0, e1), _slladd(dy, dy));
+
+	return _slladd(y0, sllmul(t, _slladd(e0, sllmul(t, _slladd(c2,
+		sllmul(t, c3))))));
+}
+
+/*
+ * Curve at xq, given the interval i with x[i] <= xq < x[i + 1]
+ */
+
+static sll _sllinterp(const sll *x, const sll *y, const sll *d, int i, sll xq)
+{
+	sll h;
+
+	h = _sllsub(x[i + 1], x[i]);
+
+	return _sllhermite(y[i], y[i + 1], d[i], d[i + 1], h,
+		_sllratio(_sllsub(xq, x[i]), h));
+}
+
+/*
+ * Cubic Hermite curve at xq
+ */
+
+sll sllinterp(const sll *x, const sll *y, const sll *d, int n, sll xq)
+{
+	int lo, hi, mid;
+
+	if (xq <= x[0])
+		return y[0];
+	if (xq >= x[n - 1])
+		return y[n - 1];
+
+	/* x[lo] <= xq < x[hi] */
+	for (lo = 0, hi = n - 1; hi - lo > 1; ) {
+		mid = (lo + hi) >> 1;
+		if (x[mid] <= xq)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	return _sllinterp(x, y, d, lo, xq);
+}
+
+/*
+ * Cubic Hermite curve with uniform knots at xq
+ */
+
+sll sllinterpu(const sll *y, const sll *d, int n, sll x0, sll h, sll xq)
+{
+	int i;
+	sll t;
+
+	if (xq <= x0)
+		return y[0];
+
+	t = _sllratio(_sllsub(xq, x0), h);
+	if (t >= int2sll(n - 1))
+		return y[n - 1];
+
+	i = _sll2int(t);
+
+	return _sllhermite(y[i], y[i + 1], d[i], d[i + 1], h, sllfrac(t));
+}
+
+/*
+ * Cubic Hermite curve at sorted queries
+ *
+ * Description
+ *
+ *	The interval only moves forward, so the scan over all m queries
+ *	passes each knot once.
+ */
+
+void sllinterpv(sll *yq, const sll *xq, int m, const sll *x, const sll *y,
+	const sll *d, int n)
+{
+	int i, j;
+
+	for (i = 0, j = 0; j < m; j++) {
+		if (xq[j] <= x[0]) {
+			yq[j] = y[0];
+			continue;
+		}
+		if (xq[j] >= x[n - 1]) {
+			yq[j] = y[n - 1];
+			continue;
+		}
+		while (x[i + 1] <= xq[j])
+			i++;
+		yq[j] = _sllinterp(x, y, d, i, xq[j]);
+	}
+}
+
+/*
+ * Cubic Hermite curve with uniform knots at queries
+ */
+
+void sllinterpuv(sll *yq, const sll *xq, int m, const sll *y, const sll *d,
+	int n, sll x0, sll h)
+{
+	int j;
+
+	for (j = 0; j < m; j++)
+		yq[j] = sllinterpu(y, d, n, x0, h, xq[j]);
+}
+
+/*
+ * e^x for activations, where -0.35 <= x <= 0.35
+ *
+ * Description
+ *
+ *	Full precision takes the series of _sllexp().  Fast precision takes a
+ *	degree 4 polynomial through the Chebyshev nodes, with a relative error
+ *	under 3.5e-6.
+ */
+
+static const sll _sllexp_fast[5] = {
+	0x0000000100000000LL, 0x00000000fffd8769LL, 0x000000007fff96aaLL,
+	0x000000002afce61bLL, 0x000000000ab85cbbLL
+};
+
+static sll _sllactexp1(sll x, int prec)
+{
+	sll retval;
+
+	if (prec != SLLACT_FAST)
+		return _sllexp(x);
+
+	retval = _slladd(_sllexp_fast[3], sllmul(x, _sllexp_fast[4]));
+	retval = _slladd(_sllexp_fast[2], sllmul(x, retval));
+	retval = _slladd(_sllexp_fast[1], sllmul(x, retval));
+
+	return _slladd(_sllexp_fast[0], sllmul(x, retval));
+}
+
+/*
+ * e^x for activations, where x <= 0
+ *
+ * Description
+ *
+ *	e^x = 2^k * e^(f * ln 2)
+ *
+ *	where x / ln 2 = k + f, k an integer and -1 / 2 <= f < 1 / 2, so the
+ *	scaling is a shift.
+ */
+
+static sll _sllactexp(sll x, int prec)
+{
+	int k;
+	sll t;
+	sll retval;
+
+	/* e^-23 < 2^-33 */
+	if (x < _sllneg(_int2sll(23)))
+		return CONST_0;
+
+	t = sllmul(x, CONST_LOG2_E);
+	k = _sll2int(_slladd(t, CONST_1_2));
+	retval = _sllactexp1(sllmul(_sllsub(t, _int2sll(k)), CONST_LN2), prec);
+
+	/* k <= 0, rounded */
+	return (k < 0) ? (retval + ((sll) 1 << (-k - 1))) >> -k: retval;
+}
+
+/*
+ * 1 / x for activations, where 1 <= x <= 2
+ *
+ * Description
+ *
+ *	The line 24 / 17 - 8 / 17 * x is within 1 / 17 of 1 / x, and each
+ *	Newton step squares the relative error, so 2 steps give fast
+ *	precision and 3 give full precision.
+ */
+
+static sll _sllactinv(sll x, int prec)
+{
+	int i;
+	sll retval;
+
+	retval = _sllsub(0x0000000169696969LL, sllmul(x, 0x0000000078787878LL));
+	for (i = (prec == SLLACT_FAST) ? 2: 3; i; i--)
+		retval = sllmul(retval, _sllsub(CONST_2, sllmul(x, retval)));
+
+	return retval;
+}
+
+/*
+ * ln(1 + x) for activations, where 0 <= x <= 1
+ *
+ * Description
+ *
+ *	ln(1 + x) = 2 * atanh(z) = 2 * (z + z^3 / 3 + z^5 / 5 + ...)
+ *
+ *	where z = x / (2 + x) <= 1 / 3.  The terms fall by at least 9 each, so
+ *	10 give full precision and 5 give fast precision.
+ */
+
+static sll _sllactlog1p(sll x, int prec)
+{
+	int k;
+	sll z, z2;
+	sll retval;
+
+	x = slldiv2(x);
+	z = sllmul(x, _sllactinv(_slladd(CONST_1, x), prec));
+	z2 = sllmul(z, z);
+
+	k = (prec == SLLACT_FAST) ? 4: 9;
+	for (retval = CONST_0; k > 0; k--)
+		retval = sllmul(z2, _slladd(retval, _sllatanh_k[k - 1]));
+
+	return sllmul2(_slladd(z, sllmul(z, retval)));
+}
+
+/*
+ * Sigmoid
+ *
+ * Description
+ *
+ *	1 / (1 + e^-x) for x >= 0, and 1 minus that of -x otherwise, so e^x is
+ *	only taken of -|x|, and the reciprocal only of 1 to 2.
+ */
+
+static sll _sllsigmoid(sll x, int prec)
+{
+	sll retval;
+
+	retval = _sllactinv(_slladd(CONST_1, _sllactexp(_sllneg(_sllabs(x)),
+		prec)), prec);
+
+	return (x < CONST_0) ? _sllsub(CONST_1, retval): retval;
+}
+
+/*
+ * Hyperbolic tangent
+ *
+ * Description
+ *
+ *	tanh |x| = (1 - e^(-2 * |x|)) / (1 + e^(-2 * |x|))
+ *
+ *	The denominator is from 1 to 2, as in _sllsigmoid().
+ */
+
+static sll _slltanh(sll x, int prec)
+{
+	sll e;
+	sll retval;
+
+	e = _sllactexp(_sllneg(sllmul2(_sllabs(x))), prec);
+	retval = sllmul(_sllsub(CONST_1, e), _sllactinv(_slladd(CONST_1, e),
+		prec));
+
+	return (x < CONST_0) ? _sllneg(retval): retval;
+}
+
+/*
+ * Softplus
+ *
+ * Description
+ *
+ *	ln(1 + e^x) = max(x, 0) + ln(1 + e^-|x|)
+ */
+
+static sll _sllsoftplus(sll x, int prec)
+{
+	sll retval;
+
+	retval = _sllactlog1p(_sllactexp(_sllneg(_sllabs(x)), prec), prec);
+
+	return (x > CONST_0) ? _slladd(x, retval): retval;
+}
+
+/*
+ * Gaussian error linear unit
+ *
+ * Description
+ *
+ *	x * PHI(x) ~= x / 2 * (1 + tanh((2 / PI)^(1 / 2) * (x + 0.044715 * x^3)))
+ *
+ *	Beyond |x| = 8, PHI(x) is within 2^-32 of 0 or 1.
+ */
+
+static sll _sllgelu(sll x, int prec)
+{
+	sll t;
+
+	if (x > _int2sll(8))
+		return x;
+	if (x < _sllneg(_int2sll(8)))
+		return CONST_0;
+
+	/* sqrt(2 / PI) and 0.044715 * sqrt(2 / PI) */
+	t = sllmul(x, sllmul(x, x));
+	t = _slladd(sllmul(x, 0x00000000cc42299fLL), sllmul(t,
+		0x0000000009222795LL));
+
+	return slldiv2(_slladd(x, sllmul(x, _slltanh(t, prec))));
+}
+
+/*
+ * Sigmoid, tanh, GELU and softplus at full precision
+ */
+
+sll sllsigmoid(sll x)
+{
+	return _sllsigmoid(x, SLLACT_FULL);
+}
+
+sll sllsoftplus(sll x)
+{
+	return _sllsoftplus(x, SLLACT_FULL);
+}
+
+sll sllgelu(sll x)
+{
+	return _sllgelu(x, SLLACT_FULL);
+}
+
+/*
+ * Activations of arrays
+ */
+
+void sllsigmoidv(sll *y, const sll *x, int n, int prec)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = _sllsigmoid(x[i], prec);
+}
+
+void slltanhv(sll *y, const sll *x, int n, int prec)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = _slltanh(x[i], prec);
+}
+
+void sllgeluv(sll *y, const sll *x, int n, int prec)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = _sllgelu(x[i], prec);
+}
+
+void sllsoftplusv(sll *y, const sll *x, int n, int prec)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = _sllsoftplus(x[i], prec);
+}
+
+/*
+ * Softmax of an array
+ *
+ * Description
+ *
+ *	y[i] = e^(x[i] - m) / SUM e^(x[j] - m)
+ *
+ *	with m the largest x.  The sum is at least 1, as the largest term is
+ *	1, so its reciprocal is taken once and each term multiplied by it.
+ *	y may be the same as x.
+ */
+
+void sllsoftmaxv(sll *y, const sll *x, int n, int prec)
+{
+	int i;
+	sll m;
+	sll r;
+	sllacc sum;
+
+	if (n <= 0)
+		return;
+
+	m = sllmaxv(x, n);
+	sllacczero(&sum);
+	for (i = 0; i < n; i++) {
+		y[i] = _sllactexp(_sllsub(x[i], m), prec);
+		sllaccadd(&sum, y[i]);
+	}
+
+	r = _sllratio(CONST_1, sllacc2sll(&sum));
+	for (i = 0; i < n; i++)
+		y[i] = sllmul(y[i], r);
+}
+
+/*
+ * Layer activation of a chopped accumulation
+ */
+
+static sll _sllact(sllacc *acc, int act, int prec)
+{
+	sll x;
+
+	x = sllacc2sll(acc);
+
+	switch (act) {
+	case SLLACT_RELU:
+		return (x < CONST_0) ? CONST_0: x;
+	case SLLACT_SIGMOID:
+		return _sllsigmoid(x, prec);
+	case SLLACT_TANH:
+		return _slltanh(x, prec);
+	case SLLACT_GELU:
+		return _sllgelu(x, prec);
+	case SLLACT_SOFTPLUS:
+		return _sllsoftplus(x, prec);
+	}
+
+	return x;
+}
+
+/*
+ * Dense layer
+ */
+
+void slldense(sll *y, const sll *x, const sll *w, const sll *b, int n, int m,
+	int p, int act, int prec)
+{
+	int i, j;
+	sllacc acc;
+
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < p; j++) {
+			sllacczero(&acc);
+			if (b)
+				sllaccadd(&acc, b[j]);
+			_slldot(&acc, &x[i * m], 1, &w[j * m], 1, m);
+			y[i * p + j] = _sllact(&acc, act, prec);
+		}
+	}
+}
+
+/*
+ * Direct convolution
+ *
+ * Description
+ *
+ *	Padding is ph rows and pw columns.  Rather than test each tap, the
+ *	range of kernel rows and columns that fall inside the input is worked
+ *	out once for each output position, and the padding contributes
+ *	nothing.
+ */
+
+static void _sllconv(const sllconv *c, sll *y, const sll *x, int h, int w,
+	int ph, int pw)
+{
+	int o, i;
+	int oy, ox;
+	int ho, wo;
+	int iy, ix;
+	int ky0, ky1, kx0, kx1;
+	int ky;
+	const sll *wk;
+	sllacc acc;
+
+	ho = (h + 2 * ph - c->kh) / c->stride + 1;
+	wo = (w + 2 * pw - c->kw) / c->stride + 1;
+
+	for (o = 0; o < c->cout; o++) {
+		for (oy = 0; oy < ho; oy++) {
+			iy = oy * c->stride - ph;
+			ky0 = (iy < 0) ? -iy: 0;
+			ky1 = (iy + c->kh > h) ? h - iy: c->kh;
+
+			for (ox = 0; ox < wo; ox++) {
+				ix = ox * c->stride - pw;
+				kx0 = (ix < 0) ? -ix: 0;
+				kx1 = (ix + c->kw > w) ? w - ix: c->kw;
+
+				sllacczero(&acc);
+				if (c->b)
+					sllaccadd(&acc, c->b[o]);
+				for (i = 0; i < c->cin; i++) {
+					wk = &c->w[((o * c->cin + i) * c->kh) *
+						c->kw];
+					for (ky = ky0; ky < ky1; ky++)
+						_slldot(&acc, &x[(i * h + iy +
+							ky) * w + ix + kx0], 1,
+							&wk[ky * c->kw + kx0],
+							1, kx1 - kx0);
+				}
+				*y++ = _sllact(&acc, c->act, c->prec);
+			}
+		}
+	}
+}
+
+/*
+ * 1D convolution layer
+ */
+
+void sllconv1d(const sllconv *c, sll *y, const sll *x, int len)
+{
+	sllconv c2;
+
+	/* A 1D signal is a 2D signal of height 1 */
+	c2 = *c;
+	c2.kh = 1;
+	_sllconv(&c2, y, x, 1, len, 0, c->pad);
+}
+
+/*
+ * 2D convolution layer
+ */
+
+void sllconv2d(const sllconv *c, sll *y, const sll *x, int h, int w)
+{
+	_sllconv(c, y, x, h, w, c->pad, c->pad);
+}
+
+/*
+ * Fold batch normalization into the preceding layer
+ *
+ * Description
+ *
+ *	gamma * (z - mean) / (var + eps)^(1 / 2) + beta = s * z + beta - s * mean
+ *
+ *	with s = gamma / (var + eps)^(1 / 2), so each weight of an output is
+ *	scaled by s, and its bias becomes s * (b - mean) + beta.
+ */
+
+void sllbnfold(sll *w, sll *b, const sll *gamma, const sll *beta,
+	const sll *mean, const sll *var, sll eps, int cout, int per)
+{
+	int i, j;
+	sll s;
+
+	for (i = 0; i < cout; i++) {
+		s = _sllratio(gamma[i], sllsqrt(_slladd(var[i], eps)));
+		for (j = 0; j < per; j++)
+			w[i * per + j] = sllmul(w[i * per + j], s);
+		b[i] = sllfma(s, _sllsub(b[i], mean[i]), beta[i]);
+	}
+}
+
+/*
+ * Shift right by 0 < s < 64, rounding to nearest, ties to even
+ */
+
+static ull _sllrshift(ull m, int s)
+{
+	ull r;
+	ull half;
+
+	r = m >> s;
+	m &= ((ull) 1 << s) - 1;
+	half = (ull) 1 << (s - 1);
+
+	return r + (m > half || (m == half && (r & 1)));
+}
+
+/*
+ * 1 / (a / n + eps)^(1 / 2) of a wide sum a, as y * 2^-k
+ *
+ * Description
+ *
+ *	When a / n is too large for sll, it is scaled by 4^-j first, which
+ *	adds j to k, and eps is then negligible.  The scaling is left to the
+ *	caller, so that small results keep full precision.
+ */
+
+static sll _sllrsqrtmean(const sllacc *a, int n, sll eps, int *k)
+{
+	int j;
+	int b;
+	sll v;
+	sll y;
+
+	/* a / n < 2^30 */
+	if ((b = _sllaccbits(a)) <= 94) {
+		j = 0;
+		v = _slladd(sllaccdivi(a, n), eps);
+	} else {
+		j = (b - 93) >> 1;
+		v = _sllaccshift(a, 2 * j + 32) / n;
+	}
+
+	if (v <= CONST_0) {
+		*k = 0;
+		return CONST_MAX;
+	}
+
+	y = _sllrsqrt(v, k);
+	*k += j;
+
+	return y;
+}
+
+/*
+ * Multiply by y * 2^-k, from _sllrsqrtmean()
+ */
+
+static __inline__ sll _sllmulscaled(sll x, sll y, int k)
+{
+	x = sllmul(x, y);
+
+	return (k > 0) ? x >> k: x << -k;
+}
+
+/*
+ * Layer normalization
+ */
+
+void slllayernorm(sll *y, const sll *x, const sll *gamma, const sll *beta,
+	int rows, int n, sll eps)
+{
+	int i;
+	int k;
+	sll m;
+	sll r;
+	sll v;
+	sllacc acc;
+
+	for (; rows > 0; rows--, x += n, y += n) {
+		m = sllmeanv(x, n);
+		_sllcomoment(&acc, x, m, x, m, n, 0);
+		r = _sllrsqrtmean(&acc, n, eps, &k);
+
+		for (i = 0; i < n; i++) {
+			v = _sllmulscaled(_sllsub(x[i], m), r, k);
+			if (gamma)
+				v = sllmul(v, gamma[i]);
+			y[i] = (beta) ? _slladd(v, beta[i]): v;
+		}
+	}
+}
+
+/*
+ * Root mean square normalization
+ */
+
+void sllrmsnorm(sll *y, const sll *x, const sll *gamma, int rows, int n,
+	sll eps)
+{
+	int i;
+	int k;
+	sll r;
+	sllacc acc;
+
+	for (; rows > 0; rows--, x += n, y += n) {
+		sllacczero(&acc);
+		for (i = 0; i < n; i++)
+			sllaccmac(&acc, x[i], x[i]);
+		r = _sllrsqrtmean(&acc, n, eps, &k);
+
+		for (i = 0; i < n; i++)
+			y[i] = (gamma) ? sllmul(_sllmulscaled(x[i], r, k),
+				gamma[i]): _sllmulscaled(x[i], r, k);
+	}
+}
+
+/*
+ * Unpack an IEEE 754 value of mant significand and ebits exponent bits
+ *
+ * Description
+ *
+ *	The significand with its leading 1 is shifted into 32.32, rounding to
+ *	nearest, ties to even, or saturating if it won't fit.
+ */
+
+static sll _sllunpack(ull bits, int mant, int ebits)
+{
+	int e;
+	int s;
+	int sgn;
+	ull m;
+
+	sgn = (int) (bits >> (mant + ebits)) & 1;
+	e = (int) (bits >> mant) & ((1 << ebits) - 1);
+	m = bits & (((ull) 1 << mant) - 1);
+
+	/* Infinity saturates, NaN is 0 */
+	if (e == (1 << ebits) - 1) {
+		if (m)
+			return CONST_0;
+		return (sgn) ? CONST_MIN: CONST_MAX;
+	}
+
+	/* 0 and subnormals are far below 2^-32 */
+	if (e == 0)
+		return CONST_0;
+
+	m |= (ull) 1 << mant;
+	s = e - ((1 << (ebits - 1)) - 1) - mant + 32;
+
+	if (s > 62 - mant)
+		return (sgn) ? CONST_MIN: CONST_MAX;
+	if (s >= 0)
+		m <<= s;
+	else if (s > -64)
+		m = _sllrshift(m, -s);
+	else
+		m = 0;
+
+	return (sgn) ? _sllneg((sll) m): (sll) m;
+}
+
+/*
+ * Pack an sll as an IEEE 754 value of mant significand and ebits exponent
+ * bits, rounding to nearest, ties to even
+ */
+
+static ull _sllpack(sll x, int mant, int ebits)
+{
+	int e;
+	int s;
+	ull sgn;
+	ull m;
+
+	if (x == CONST_0)
+		return 0;
+
+	sgn = (x < CONST_0);
+	m = (sgn) ? 0 - (ull) x: (ull) x;
+
+	e = _sllbits(m) - 1;
+	s = e - mant;
+	if (s > 0) {
+		m = _sllrshift(m, s);
+		/* Rounding carried into a new bit */
+		if (m >> (mant + 1)) {
+			m >>= 1;
+			e++;
+		}
+	} else {
+		m <<= -s;
+	}
+
+	e += ((1 << (ebits - 1)) - 1) - 32;
+
+	return (sgn << (mant + ebits)) | ((ull) e << mant) |
+		(m & (((ull) 1 << mant) - 1));
+}
+
+/*
+ * Bits of a double, and a double from bits
+ */
+
+static ull _slldblbits(double d)
+{
+	union {
+		double d;
+		unsigned u[2];
+		ull ull;
+	} in;
+
+	in.d = d;
+
+#if defined(BROKEN_IEEE754_DOUBLE)
+
+	in.ull = ((ull) in.u[0] << 32) | in.u[1];
+
+#endif /* defined(BROKEN_IEEE754_DOUBLE) */
+
+	return in.ull;
+}
+
+static double _slldbl(ull bits)
+{
+	union {
+		double d;
+		unsigned u[2];
+		ull ull;
+	} retval;
+
+	retval.ull = bits;
+
+#if defined(BROKEN_IEEE754_DOUBLE)
+
+	retval.u[0] = (unsigned) (bits >> 32);
+	retval.u[1] = (unsigned) bits;
+
+#endif /* defined(BROKEN_IEEE754_DOUBLE) */
+
+	return retval.d;
+}
+
+/*
+ * Convert arrays between double or float and sll
+ */
+
+void dbl2sllv(sll *y, const double *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = _sllunpack(_slldblbits(x[i]), 52, 11);
+}
+
+void flt2sllv(sll *y, const float *x, int n)
+{
+	int i;
+	union {
+		float f;
+		unsigned u;
+	} in;
+
+	for (i = 0; i < n; i++) {
+		in.f = x[i];
+		y[i] = _sllunpack(in.u, 23, 8);
+	}
+}
+
+void sll2dblv(double *y, const sll *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = _slldbl(_sllpack(x[i], 52, 11));
+}
+
+void sll2fltv(float *y, const sll *x, int n)
+{
+	int i;
+	union {
+		float f;
+		unsigned u;
+	} retval;
+
+	for (i = 0; i < n; i++) {
+		retval.u = (unsigned) _sllpack(x[i], 23, 8);
+		y[i] = retval.f;
+	}
+}
+
+/*
+ * Convert arrays between Q16.16 and sll
+ */
+
+void sll2q16v(int *y, const sll *x, int n)
+{
+	int i;
+	sll q;
+
+	for (i = 0; i < n; i++) {
+		q = (slladdsat(x[i], (sll) 1 << 15)) >> 16;
+		y[i] = (q > 0x7fffffffLL) ? 0x7fffffff:
+			(q < -0x80000000LL) ? (int) -0x80000000LL: (int) q;
+	}
+}
+
+void q162sllv(sll *y, const int *x, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = (sll) x[i] * 0x10000;
+}
+
+/*
+ * Quantize to int8
+ *
+ * Description
+ *
+ *	x / scale is an integer division of the raw values, rounded half up,
+ *	so it is exact for any scale down to 2^-32.  The quotient is clamped
+ *	before the zero point is added.  A scale <= 0 gives the zero point.
+ */
+
+static void _sllquant8(signed char *q, const sll *x, int n, sll scale,
+	int zero)
+{
+	int i;
+	sll r;
+	sll v;
+
+	for (i = 0; i < n; i++) {
+		if (scale <= CONST_0) {
+			v = zero;
+		} else {
+			v = x[i] / scale;
+			r = x[i] - v * scale;
+			if (r >= CONST_0 && r >= scale - r)
+				v++;
+			else if (r < CONST_0 && -r > scale + r)
+				v--;
+			v = ((v > 256) ? 256: (v < -256) ? -256: v) + zero;
+		}
+		q[i] = (signed char) ((v > 127) ? 127: (v < -128) ? -128: v);
+	}
+}
+
+void sllquant8(signed char *q, const sll *x, int n, sll scale, int zero)
+{
+	_sllquant8(q, x, n, scale, zero);
+}
+
+void sllquant8c(signed char *q, const sll *x, int c, int per,
+	const sll *scale, const int *zero)
+{
+	int i;
+
+	for (i = 0; i < c; i++)
+		_sllquant8(&q[i * per], &x[i * per], per, scale[i],
+			(zero) ? zero[i]: 0);
+}
+
+/*
+ * Dequantize from int8
+ */
+
+void slldequant8(sll *x, const signed char *q, int n, sll scale, int zero)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		x[i] = scale * (q[i] - zero);
+}
+
+void slldequant8c(sll *x, const signed char *q, int c, int per,
+	const sll *scale, const int *zero)
+{
+	int i;
+
+	for (i = 0; i < c; i++)
+		slldequant8(&x[i * per], &q[i * per], per, scale[i],
+			(zero) ? zero[i]: 0);
+}
+
+/*
+ * int8 scale and zero point for a range
+ *
+ * Description
+ *
+ *	The range is widened to take in 0, so that 0 is exact.  A symmetric
+ *	range maps [-a, a] onto [-127, 127], with a the larger magnitude, and
+ *	otherwise [lo, hi] maps onto [-128, 127].
+ */
+
+void sllq8range(sll *scale, int *zero, sll lo, sll hi, int symmetric)
+{
+	sll a;
+
+	if (lo > CONST_0)
+		lo = CONST_0;
+	if (hi < CONST_0)
+		hi = CONST_0;
+
+	if (symmetric) {
+		a = (_sllneg(lo) > hi) ? _sllneg(lo): hi;
+		*scale = a / 127;
+		*zero = 0;
+	} else {
+		*scale = _sllsub(hi, lo) / 255;
+		*zero = (*scale) ? -128 - _sll2int(_slladd(_sllratio(lo,
+			*scale), CONST_1_2)): 0;
+	}
+
+	/* The smallest positive scale */
+	if (*scale == CONST_0)
+		*scale = 1;
+}
+
+/*
+ * Quantile of an array
+ *
+ * Description
+ *
+ *	The value at position p * (n - 1) of x sorted, interpolated between
+ *	neighbours.  Quickselect, with the middle of three as pivot, puts the
+ *	k-th smallest at x[k] in O(n) on average, and the next is the least
+ *	of those after it.  The partition is three-way, below, equal to and
+ *	above the pivot, so it stops as soon as k is among the equal values,
+ *	and ties, common in calibration data, don't make it quadratic.
+ */
+
+sll sllpercentile(sll *x, int n, sll p)
+{
+	int i, j;
+	int lo, hi;
+	int lt, gt;
+	int k;
+	sll t;
+	sll v;
+	sll f;
+
+	if (n <= 0)
+		return CONST_0;
+
+	t = sllmul(sllclamp(p, CONST_0, CONST_1), _int2sll(n - 1));
+	k = _sll2int(t);
+	f = sllfrac(t);
+
+	for (lo = 0, hi = n - 1; lo < hi; ) {
+		/* Middle of three */
+		i = lo + ((hi - lo) >> 1);
+		if ((x[i] < x[lo]) != (x[i] < x[hi]))
+			j = i;
+		else if ((x[lo] < x[i]) != (x[lo] < x[hi]))
+			j = lo;
+		else
+			j = hi;
+		v = x[j];
+
+		/* x[lo..lt - 1] < v, x[lt..gt] == v, x[gt + 1..hi] > v */
+		for (lt = lo, gt = hi, i = lo; i <= gt; ) {
+			t = x[i];
+			if (t < v) {
+				x[i++] = x[lt];
+				x[lt++] = t;
+			} else if (t > v) {
+				x[i] = x[gt];
+				x[gt--] = t;
+			} else {
+				i++;
+			}
+		}
+
+		if (k < lt)
+			hi = lt - 1;
+		else if (k > gt)
+			lo = gt + 1;
+		else
+			break;
+	}
+
+	if (f == CONST_0 || k == n - 1)
+		return x[k];
+
+	return _slladd(x[k], sllmul(f, _sllsub(sllminv(&x[k + 1],
+		n - k - 1), x[k])));
+}
+
+/*
+ * Kalman filter predict
+ *
+ * Description
+ *
+ *	x = f * x
+ *	p = f * p * f^T + q
+ *
+ *	Only the upper triangle of p is computed, then mirrored, which
+ *	halves the work and keeps p exactly symmetric.
+ */
+
+void sllkfpredict(sllkf *k)
+{
+	int i, j;
+	int n;
+	sll t[SLLKF_MAX * SLLKF_MAX];
+	sll xn[SLLKF_MAX];
+	sllacc acc;
+
+	n = k->n;
+
+	sllmatmul(xn, k->f, k->x, n, n, 1);
+	for (i = 0; i < n; i++)
+		k->x[i] = xn[i];
+
+	/* t = f * p */
+	sllmatmul(t, k->f, k->p, n, n, n);
+
+	/* p = t * f^T + q */
+	for (i = 0; i < n; i++) {
+		for (j = i; j < n; j++) {
+			sllacczero(&acc);
+			sllaccadd(&acc, k->q[i * n + j]);
+			_slldot(&acc, &t[i * n], 1, &k->f[j * n], 1, n);
+			k->p[i * n + j] = sllacc2sll(&acc);
+			k->p[j * n + i] = k->p[i * n + j];
+		}
+	}
+}
+
+/*
+ * Kalman filter measurement update
+ *
+ * Description
+ *
+ *	y = z - h * x
+ *	s = h * p * h^T + r
+ *	k = p * h^T * s^-1
+ *	x = x + k * y
+ *	p = (I - k * h) * p * (I - k * h)^T + k * r * k^T
+ *
+ *	The Joseph form of the covariance update keeps p symmetric and
+ *	positive definite in spite of rounding in k, which the short form
+ *	p = (I - k * h) * p does not.
+ *
+ *	s is factored with sllcholesky() rather than inverted:  since p and
+ *	s are symmetric, k^T = s^-1 * (h * p), a Cholesky solve.
+ *
+ *	Both terms of the new p are summed in one wide accumulation, so each
+ *	element is chopped once.
+ */
+
+int sllkfupdate(sllkf *k, const sll *z)
+{
+	int i, j, c;
+	int n, m;
+	sll hp[SLLKF_MAX * SLLKF_MAX];
+	sll s[SLLKF_MAX * SLLKF_MAX];
+	sll l[SLLKF_MAX * SLLKF_MAX];
+	sll kt[SLLKF_MAX * SLLKF_MAX];
+	sll a[SLLKF_MAX * SLLKF_MAX];
+	sll ap[SLLKF_MAX * SLLKF_MAX];
+	sll kr[SLLKF_MAX * SLLKF_MAX];
+	sll y[SLLKF_MAX];
+	sllacc acc;
+
+	n = k->n;
+	m = k->m;
+
+	/* y = z - h * x */
+	for (i = 0; i < m; i++) {
+		sllacczero(&acc);
+		sllaccadd(&acc, z[i]);
+		for (j = 0; j < n; j++)
+			sllaccmsub(&acc, k->h[i * n + j], k->x[j]);
+		y[i] = sllacc2sll(&acc);
+	}
+
+	/* hp = h * p, s = hp * h^T + r */
+	sllmatmul(hp, k->h, k->p, m, n, n);
+	for (i = 0; i < m; i++) {
+		for (j = i; j < m; j++) {
+			sllacczero(&acc);
+			sllaccadd(&acc, k->r[i * m + j]);
+			_slldot(&acc, &hp[i * n], 1, &k->h[j * n], 1, n);
+			s[i * m + j] = sllacc2sll(&acc);
+			s[j * m + i] = s[i * m + j];
+		}
+	}
+
+	/* k^T = s^-1 * hp, m x n */
+	if (!sllcholesky(l, s, m))
+		return 0;
+	sllcholsolve(kt, l, hp, m, n);
+
+	/* x = x + k * y */
+	for (i = 0; i < n; i++) {
+		sllacczero(&acc);
+		sllaccadd(&acc, k->x[i]);
+		_slldot(&acc, &kt[i], n, y, 1, m);
+		k->x[i] = sllacc2sll(&acc);
+	}
+
+	/* a = I - k * h */
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < n; j++) {
+			sllacczero(&acc);
+			if (i == j)
+				sllaccadd(&acc, CONST_1);
+			for (c = 0; c < m; c++)
+				sllaccmsub(&acc, kt[c * n + i], k->h[c * n + j]);
+			a[i * n + j] = sllacc2sll(&acc);
+		}
+	}
+
+	/* ap = a * p, kr = k * r */
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < n; j++) {
+			sllacczero(&acc);
+			_slldot(&acc, &a[i * n], 1, &k->p[j], n, n);
+			ap[i * n + j] = sllacc2sll(&acc);
+		}
+		for (j = 0; j < m; j++) {
+			sllacczero(&acc);
+			_slldot(&acc, &kt[i], n, &k->r[j], m, m);
+			kr[i * m + j] = sllacc2sll(&acc);
+		}
+	}
+
+	/* p = ap * a^T + kr * k^T */
+	for (i = 0; i < n; i++) {
+		for (j = i; j < n; j++) {
+			sllacczero(&acc);
+			_slldot(&acc, &ap[i * n], 1, &a[j * n], 1, n);
+			_slldot(&acc, &kr[i * m], 1, &kt[j], n, m);
+			k->p[i * n + j] = sllacc2sll(&acc);
+			k->p[j * n + i] = k->p[i * n + j];
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Kalman filter predict over many filters
+ */
+
+void sllkfpredictv(sllkf *k, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		sllkfpredict(&k[i]);
+}
+
+/*
+ * Kalman filter measurement update over many filters
+ */
+
+int sllkfupdatev(sllkf *k, const sll *z, int count)
+{
+	int i;
+	int retval;
+
+	retval = 0;
+	for (i = 0; i < count; i++) {
+		retval += sllkfupdate(&k[i], z);
+		z += k[i].m;
+	}
+
+	return retval;
+}
+
+/*
+ * One step of a PID controller
  *
- *	Taking the roots of both sides
- *	X^(1 / 2) = (4^n * z)^(1 / 2)
- *	X^(1 / 2) = 2^n * z^(1 / 2)
+ * Description
  *
- *	Letting N = 2^n results in:
- *	x^(1 / 2) = N * z^(1 / 2)
+ *	e = sp - pv
+ *	i = clamp (i + ki * e, imin, imax)
+ *	d = d + alpha * (-kd * (pv - pv_prev) - d)
+ *	out = clamp (kp * e + i + d, omin, omax)
  *
- *	We want this to converge to the positive root, so we must start at a point
- *	0 < start <= x^(1 / 2)
- * 	or
- *	x^(1/2) <= start <= infinity
+ *	If the output saturates and e would push it further, the integral
+ *	keeps its old value (conditional integration), so it doesn't wind up.
+ */
+
+static sll _sllpid(sll kp, sll ki, sll kd, sll alpha, sll imin, sll imax,
+	sll omin, sll omax, sll *i, sll *d, sll *pv_prev, sll sp, sll pv)
+{
+	sll e;
+	sll in;
+	sll dn;
+	sll u;
+
+	e = sllsubsat(sp, pv);
+
+	in = sllclamp(slladdsat(*i, sllmulsat(ki, e)), imin, imax);
+
+	dn = sllmulsat(kd, sllsubsat(*pv_prev, pv));
+	dn = slladdsat(*d, sllmulsat(alpha, sllsubsat(dn, *d)));
+
+	u = slladdsat(slladdsat(sllmulsat(kp, e), in), dn);
+
+	/* Conditional integration */
+	if ((u > omax && e > 0) || (u < omin && e < 0)) {
+		in = *i;
+		u = slladdsat(slladdsat(sllmulsat(kp, e), in), dn);
+	}
+
+	*i = in;
+	*d = dn;
+	*pv_prev = pv;
+
+	return sllclamp(u, omin, omax);
+}
+
+/*
+ * Reset a PID controller
+ */
+
+void sllpidreset(sllpid *p, sll pv)
+{
+	p->i = CONST_0;
+	p->d = CONST_0;
+	p->pv = pv;
+}
+
+/*
+ * One step of a PID controller
+ */
+
+sll sllpidstep(sllpid *p, sll sp, sll pv)
+{
+	return _sllpid(p->kp, p->ki, p->kd, p->alpha, p->imin, p->imax,
+		p->omin, p->omax, &p->i, &p->d, &p->pv, sp, pv);
+}
+
+/*
+ * Reset a bank of PID controllers
+ */
+
+void sllpidbankreset(sllpidbank *b, const sll *pv)
+{
+	int k;
+
+	for (k = 0; k < b->n; k++) {
+		b->i[k] = CONST_0;
+		b->d[k] = CONST_0;
+		b->pv[k] = pv[k];
+	}
+}
+
+/*
+ * One step of a bank of PID controllers
+ */
+
+void sllpidbankstep(sllpidbank *b, sll *out, const sll *sp, const sll *pv)
+{
+	int k;
+
+	for (k = 0; k < b->n; k++)
+		out[k] = _sllpid(b->kp[k], b->ki[k], b->kd[k], b->alpha[k],
+			b->imin[k], b->imax[k], b->omin[k], b->omax[k],
+			&b->i[k], &b->d[k], &b->pv[k], sp[k], pv[k]);
+}
+
+/*
+ * Phase currents to rotor frame
  *
- *	Since:
- *	(1/2)^(1/2) = 0.707
- *	2^(1/2) = 1.414
+ * Description
  *
- *	A good choice is 1 which lies in the middle, and takes 4 iterations to
- *	converge from either extreme.
+ *	Clarke then Park, with the sin and cos of the rotor angle taken from
+ *	the table in sllsincosbam().
  */
 
-sll sllsqrt(sll x)
+void sllclarkepark(sll *d, sll *q, sll a, sll b, unsigned theta)
+{
+	sll alpha;
+	sll beta;
+	sll s;
+	sll c;
+
+	sllsincosbam(theta, &s, &c);
+	sllclarke(&alpha, &beta, a, b);
+	sllpark(d, q, alpha, beta, s, c);
+}
+
+/*
+ * Rotor frame to phase values
+ *
+ * Description
+ *
+ *	Inverse Park then inverse Clarke.
+ */
+
+void sllinvparkclarke(sll *a, sll *b, sll *c, sll d, sll q, unsigned theta)
+{
+	sll alpha;
+	sll beta;
+	sll sn;
+	sll cs;
+
+	sllsincosbam(theta, &sn, &cs);
+	sllinvpark(&alpha, &beta, d, q, sn, cs);
+	sllinvclarke(a, b, c, alpha, beta);
+}
+
+/*
+ * Phase currents to rotor frame over many motors
+ */
+
+void sllclarkeparkv(sll *d, sll *q, const sll *a, const sll *b,
+	const unsigned *theta, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		sllclarkepark(&d[i], &q[i], a[i], b[i], theta[i]);
+}
+
+/*
+ * Rotor frame to phase values over many motors
+ */
+
+void sllinvparkclarkev(sll *a, sll *b, sll *c, const sll *d,
+	const sll *q, const unsigned *theta, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		sllinvparkclarke(&a[i], &b[i], &c[i], d[i], q[i], theta[i]);
+}
+
+/*
+ * Great-circle inverse problem on a sphere
+ *
+ * Description
+ *
+ *	With p1, p2 the latitudes and L the difference in longitude:
+ *
+ *	Y = cos p2 * sin L
+ *	X = cos p1 * sin p2 - sin p1 * cos p2 * cos L
+ *	Z = sin p1 * sin p2 + cos p1 * cos p2 * cos L
+ *
+ *	bearing = atan2 (Y, X)
+ *	angle = atan2 ((X^2 + Y^2)^(1 / 2), Z)
+ *
+ *	This is the same central angle as the haversine formula, but short
+ *	distances don't vanish:  the haversine squares sin (angle / 2), which
+ *	drops below 2^-32 for anything under about a kilometre on the Earth,
+ *	while the above keeps an absolute error of a few 2^-32 radians, or a
+ *	few millimetres on the Earth, and needs no asin.
+ *
+ *	The three sincos reductions and the hypotenuse are shared between the
+ *	distance and the bearing.
+ */
+
+void sllgcinv(sll *d, sll *b, sll lat1, sll lon1, sll lat2, sll lon2)
+{
+	sll s1, c1;
+	sll s2, c2;
+	sll sl, cl;
+	sll c2cl;
+	sll x, y, z;
+
+	sllsincos(lat1, &s1, &c1);
+	sllsincos(lat2, &s2, &c2);
+	sllsincos(_sllsub(lon2, lon1), &sl, &cl);
+
+	c2cl = sllmul(c2, cl);
+	y = sllmul(c2, sl);
+	x = _sllsub(sllmul(c1, s2), sllmul(s1, c2cl));
+	z = _slladd(sllmul(s1, s2), sllmul(c1, c2cl));
+
+	if (d)
+		*d = sllatan2(sllhypot(x, y), z);
+	if (b)
+		*b = sllatan2(y, x);
+}
+
+/*
+ * Great-circle central angle
+ */
+
+sll sllgcdist(sll lat1, sll lon1, sll lat2, sll lon2)
+{
+	sll d;
+
+	sllgcinv(&d, 0, lat1, lon1, lat2, lon2);
+
+	return d;
+}
+
+/*
+ * Great-circle initial bearing
+ */
+
+sll sllgcbearing(sll lat1, sll lon1, sll lat2, sll lon2)
+{
+	sll b;
+
+	sllgcinv(0, &b, lat1, lon1, lat2, lon2);
+
+	return b;
+}
+
+/*
+ * Great-circle central angles over arrays
+ */
+
+void sllgcdistv(sll *d, const sll *lat1, const sll *lon1,
+	const sll *lat2, const sll *lon2, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		sllgcinv(&d[i], 0, lat1[i], lon1[i], lat2[i], lon2[i]);
+}
+
+/*
+ * Great-circle initial bearings over arrays
+ */
+
+void sllgcbearingv(sll *b, const sll *lat1, const sll *lon1,
+	const sll *lat2, const sll *lon2, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		sllgcinv(0, &b[i], lat1[i], lon1[i], lat2[i], lon2[i]);
+}
+
+/*
+ * Geodetic to ECEF
+ *
+ * Description
+ *
+ *	N = a / (1 - e^2 * sin^2 lat)^(1 / 2)
+ *
+ *	x = (N + h) * cos lat * cos lon
+ *	y = (N + h) * cos lat * sin lon
+ *	z = (N * (1 - e^2) + h) * sin lat
+ */
+
+void sllgeo2ecef(sll *x, sll *y, sll *z, sll lat, sll lon, sll h)
 {
+	sll sp, cp;
+	sll sl, cl;
 	sll n;
-	sll xn;
-       
-	/* Quick solutions for the simple cases */
-	if (x <= CONST_0 || x == CONST_1)
-		return x;
+	sll r;
 
-	/* Start with a scaling factor of 1 */
-	n = CONST_1;
+	sllsincos(lat, &sp, &cp);
+	sllsincos(lon, &sl, &cl);
 
-	/* Scale x so that 0.5 <= x < 2 */
-	while (x >= CONST_2) {
-		x = slldiv4(x);
-		n = sllmul2(n);
-	}
-	while (x < CONST_1_2) {
-		x = sllmul4(x);
-		n = slldiv2(n);
+	n = slldiv(CONST_WGS84_A, sllsqrt(_sllsub(CONST_1,
+		sllmul(CONST_WGS84_E2, sllmul(sp, sp)))));
+
+	r = sllmul(_slladd(n, h), cp);
+	*x = sllmul(r, cl);
+	*y = sllmul(r, sl);
+	*z = sllmul(_slladd(sllmul(n, CONST_WGS84_1_E2), h), sp);
+}
+
+/*
+ * ECEF to geodetic
+ *
+ * Description
+ *
+ *	Bowring's method, which is good to well under a millimetre for any
+ *	height near the surface of the Earth:
+ *
+ *	p = (x^2 + y^2)^(1 / 2)
+ *	tan t = (z * a) / (p * b)
+ *	tan lat = (z + e'^2 * b * sin^3 t) / (p - e^2 * a * cos^3 t)
+ *	h = p * cos lat + z * sin lat - a * (1 - e^2 * sin^2 lat)^(1 / 2)
+ *
+ *	Squares of ECEF coordinates overflow, so the sin and cos of both t and
+ *	lat come from normalizing the tangent's numerator and denominator by
+ *	their hypotenuse, rather than from atan and sincos.  The only atan2
+ *	calls are the ones producing the results.
+ */
+
+void sllecef2geo(sll *lat, sll *lon, sll *h, sll x, sll y, sll z)
+{
+	sll p;
+	sll u, v;
+	sll r;
+	sll st, ct;
+	sll sp, cp;
+
+	p = sllhypot(x, y);
+
+	/* Parametric latitude */
+	u = sllmul(z, CONST_WGS84_A_B);
+	r = sllhypot(u, p);
+	if (r == CONST_0) {
+		*lat = CONST_0;
+		*lon = CONST_0;
+		*h = _sllneg(CONST_WGS84_B);
+		return;
 	}
+	st = _sllratio(u, r);
+	ct = _sllratio(p, r);
 
-	/* Simple solution if x = 4^n */
-	if (x == CONST_1)
-		return n;
+	/* Geodetic latitude */
+	u = _slladd(z, sllmul(CONST_WGS84_EP2B, sllmul(st, sllmul(st, st))));
+	v = _sllsub(p, sllmul(CONST_WGS84_E2A, sllmul(ct, sllmul(ct, ct))));
+	r = sllhypot(u, v);
+	sp = _sllratio(u, r);
+	cp = _sllratio(v, r);
 
-	/* The starting point */
-	xn = CONST_1;
+	*lat = sllatan2(u, v);
+	*lon = sllatan2(y, x);
+	*h = _sllsub(_slladd(sllmul(p, cp), sllmul(z, sp)),
+		sllmul(CONST_WGS84_A, sllsqrt(_sllsub(CONST_1,
+		sllmul(CONST_WGS84_E2, sllmul(sp, sp))))));
+}
 
-	/* Four iterations will be enough */
-	xn = _sllsub(xn, slldiv2(_sllsub(xn, slldiv(x, xn))));
-	xn = _sllsub(xn, slldiv2(_sllsub(xn, slldiv(x, xn))));
-	xn = _sllsub(xn, slldiv2(_sllsub(xn, slldiv(x, xn))));
-	xn = _sllsub(xn, slldiv2(_sllsub(xn, slldiv(x, xn))));
+/*
+ * Prepare an ENU frame with its origin at a geodetic position
+ */
 
-	/* Scale the result */
-	return sllmul(n, xn);
+void sllenuinit(sllenu *f, sll lat, sll lon, sll h)
+{
+	sllgeo2ecef(&f->x0, &f->y0, &f->z0, lat, lon, h);
+	sllsincos(lat, &f->slat, &f->clat);
+	sllsincos(lon, &f->slon, &f->clon);
+}
+
+/*
+ * ECEF to ENU
+ *
+ * Description
+ *
+ *	With d the offset from the origin of the frame:
+ *
+ *	e = -sin lon * dx + cos lon * dy
+ *	n = -sin lat * (cos lon * dx + sin lon * dy) + cos lat * dz
+ *	u =  cos lat * (cos lon * dx + sin lon * dy) + sin lat * dz
+ */
+
+void sllecef2enu(const sllenu *f, sll *e, sll *n, sll *u,
+	sll x, sll y, sll z)
+{
+	sll t;
+
+	x = _sllsub(x, f->x0);
+	y = _sllsub(y, f->y0);
+	z = _sllsub(z, f->z0);
+
+	t = _slladd(sllmul(f->clon, x), sllmul(f->slon, y));
+	*e = _sllsub(sllmul(f->clon, y), sllmul(f->slon, x));
+	*n = _sllsub(sllmul(f->clat, z), sllmul(f->slat, t));
+	*u = _slladd(sllmul(f->clat, t), sllmul(f->slat, z));
+}
+
+/*
+ * ENU to ECEF
+ *
+ * Description
+ *
+ *	The transpose of the rotation in sllecef2enu(), plus the origin.
+ */
+
+void sllenu2ecef(const sllenu *f, sll *x, sll *y, sll *z,
+	sll e, sll n, sll u)
+{
+	sll t;
+
+	t = _sllsub(sllmul(f->clat, u), sllmul(f->slat, n));
+	*x = _slladd(f->x0, _sllsub(sllmul(f->clon, t), sllmul(f->slon, e)));
+	*y = _slladd(f->y0, _slladd(sllmul(f->slon, t), sllmul(f->clon, e)));
+	*z = _slladd(f->z0, _slladd(sllmul(f->slat, u), sllmul(f->clat, n)));
+}
+
+/*
+ * Geodetic to ECEF over arrays
+ */
+
+void sllgeo2ecefv(sll *x, sll *y, sll *z, const sll *lat,
+	const sll *lon, const sll *h, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		sllgeo2ecef(&x[i], &y[i], &z[i], lat[i], lon[i], h[i]);
+}
+
+/*
+ * ECEF to geodetic over arrays
+ */
+
+void sllecef2geov(sll *lat, sll *lon, sll *h, const sll *x,
+	const sll *y, const sll *z, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		sllecef2geo(&lat[i], &lon[i], &h[i], x[i], y[i], z[i]);
+}
+
+/*
+ * ECEF to ENU over arrays
+ */
+
+void sllecef2enuv(const sllenu *f, sll *e, sll *n, sll *u,
+	const sll *x, const sll *y, const sll *z, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		sllecef2enu(f, &e[i], &n[i], &u[i], x[i], y[i], z[i]);
 }
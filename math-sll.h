@@ -70,6 +70,7 @@
  *	sll sllcos(sll x)			cos x
  *	sll sllsin(sll x)			sin x
  *	sll slltan(sll x)			tan x
+ *	void sllsincos(sll x, sll *s, sll *c)	sin x and cos x together
  *
  *	sll sllsec(sll x)			sec x = 1 / cos x
  *	sll sllcsc(sll x)			csc x = 1 / sin x
@@ -78,6 +79,7 @@
  *	sll sllacos(sll x)			acos x
  *	sll sllasin(sll x)			asin x
  *	sll sllatan(sll x)			atan x
+ *	sll sllatan2(sll y, sll x)		atan y / x, by quadrant
  *
  *	sll sllcosh(sll x)			cosh x
  *	sll sllsinh(sll x)			sinh x
@@ -89,14 +91,563 @@
  *
  *	sll sllexp(sll x)			e^x
  *	sll slllog(sll x)			ln x
+ *	sll sllexp2(sll x)			2^x
+ *	sll slllog2(sll x)			log2 x
+ *	sll sllexp10(sll x)			10^x
+ *	sll slllog10(sll x)			log10 x
+ *	sll sllexpm1(sll x)			e^x - 1
+ *	sll slllog1p(sll x)			ln(1 + x)
+ *	void sllexp2v(sll *y, const sll *x, int n)
+ *	void slllog2v(sll *y, const sll *x, int n)
+ *	void sllexp10v(sll *y, const sll *x, int n)
+ *	void slllog10v(sll *y, const sll *x, int n)
+ *	void sllexpm1v(sll *y, const sll *x, int n)
+ *	void slllog1pv(sll *y, const sll *x, int n)
+ *						the same over arrays
  *
  *	sll sllinv(sll v)			1 / x
  *	sll sllpow(sll x, sll y)		x^y
+ *	sll sllpowi(sll x, int n)		x^n
  *	sll sllsqrt(sll x)			x^(1 / 2)
+ *	sll sllrsqrt(sll x)			x^(-1 / 2)
+ *	sll sllcbrt(sll x)			x^(1 / 3)
+ *	sll sllroot(sll x, int n)		x^(1 / n)
+ *	sll sllhypot(sll x, sll y)		(x^2 + y^2)^(1 / 2)
+ *
+ *	sll sllerf(sll x)			erf x
+ *	sll sllerfc(sll x)			1 - erf x
+ *	sll sllnormcdf(sll x)			PHI(x), standard normal
+ *	sll sllnorminv(sll p)			PHI^-1(p)
+ *	void sllerfv(sll *y, const sll *x, int n)
+ *	void sllerfcv(sll *y, const sll *x, int n)
+ *	void sllnormcdfv(sll *y, const sll *x, int n)
+ *	void sllnorminvv(sll *y, const sll *p, int n)
+ *						the same over arrays
+ *
+ *	sll slllgamma(sll x)			ln |GAMMA(x)|
+ *	sll sllgamma(sll x)			GAMMA(x)
+ *	sll sllfact(int n)			n!
+ *	sll slllogfact(int n)			ln n!
+ *	sll sllbinom(int n, int k)		n! / (k! * (n - k)!)
+ *	sll slllogbinom(int n, int k)		ln of that
+ *	sll sllbinompmf(int n, int k, sll p)	binomial probability of k
+ *	sll sllpoissonpmf(int k, sll lambda)	Poisson probability of k
+ *	void slllgammav(sll *y, const sll *x, int n)
+ *	void sllgammav(sll *y, const sll *x, int n)
+ *						the same over arrays
+ *	void sllbinompmfv(sll *y, int n, sll p)	y[k] for 0 <= k <= n
+ *	void sllpoissonpmfv(sll *y, int n, sll lambda)
+ *						y[k] for 0 <= k < n
+ *
+ *	sll slladdsat(sll x, sll y)		x + y, saturating
+ *	sll sllsubsat(sll x, sll y)		x - y, saturating
+ *	sll sllmulsat(sll x, sll y)		x * y, saturating
+ *	sll sllclamp(sll x, sll lo, sll hi)	x limited to lo <= x <= hi
  *
  *	sll sllfloor(sll x)			floor x
  *	sll sllceil(sll x)			ceiling x
  *
+ * Wide accumulation
+ *
+ *	An sllacc holds a 64.64 value, wide enough for the exact product of
+ *	two sll values and for sums of many of them, so a dot product can be
+ *	accumulated exactly and chopped once at the end.
+ *
+ *	void sllacczero(sllacc *a)		a = 0
+ *	void sllaccadd(sllacc *a, sll x)	a = a + x
+ *	void sllaccmac(sllacc *a, sll x, sll y)	a = a + x * y, exactly
+ *	void sllaccmsub(sllacc *a, sll x, sll y)
+ *						a = a - x * y, exactly
+ *	sll sllacc2sll(const sllacc *a)		a to sll (chops)
+ *	sll sllaccdivi(const sllacc *a, int d)	a / d to sll, d > 0 (chops)
+ *	sll sllfma(sll x, sll y, sll z)		x * y + z, chopped once
+ *	void sllaccmerge(sllacc *a, const sllacc *b)
+ *						a = a + b
+ *
+ * Prepared powers
+ *
+ *	For many powers of one base, an sllpowx keeps ln x, so each power is
+ *	only an e^x.  For one exponent, an sllpowy picks the quickest method
+ *	once:  sllpowi() for integral y, a square root or its reciprocal for
+ *	y = 1 / 2 or -1 / 2, sllcbrt() for y = CONST_1_3, which also takes
+ *	x < 0, and e^(y * ln x) otherwise.  It may also be given a table of
+ *	2^bits + 1 entries, filled by sllpowylut(), which gives 0 <= x < 1 by
+ *	linear interpolation.  That suits gamma correction, but is least
+ *	accurate near 0 for 0 < y < 1, where x^y is steepest.  For y < 0, x^y
+ *	is unbounded near 0, so the table isn't filled or used.
+ *
+ *	void sllpowxinit(sllpowx *p, sll x)	prepare x > 0
+ *	sll sllpowxeval(const sllpowx *p, sll y)
+ *						x^y
+ *	void sllpowxv(const sllpowx *p, sll *r, const sll *y, int n)
+ *						x^y of n y
+ *	void sllpowyinit(sllpowy *p, sll y)	prepare y
+ *	void sllpowylut(sllpowy *p, sll *lut, int bits)
+ *						fill and use a table, bits <= 16
+ *	sll sllpowyeval(const sllpowy *p, sll x)
+ *						x^y
+ *	void sllpowyv(const sllpowy *p, sll *r, const sll *x, int n)
+ *						x^y of n x
+ *
+ * Statistics
+ *
+ *	Sums are exact wide accumulations, so they neither overflow part way
+ *	nor depend on the order of the elements:  an array may be split into
+ *	chunks, summed in parallel with sllaccsumv() and combined with
+ *	sllaccmerge(), and the result is identical to the serial sum.
+ *
+ *	Variances and covariances use two passes, the mean and then exact
+ *	squares of deviations from it, and divide by n - ddof, where ddof is 0
+ *	for the population and 1 for a sample estimate.  The deviations and
+ *	the result saturate, so data spanning more than 2^31 give CONST_MAX
+ *	or CONST_MIN where the result is out of range.  The mean, minimum and
+ *	maximum of an empty array are 0.
+ *
+ *	void sllaccsumv(sllacc *a, const sll *x, int n)
+ *						a = a + SUM x
+ *	sll sllsumv(const sll *x, int n)	SUM x (chops)
+ *	sll sllmeanv(const sll *x, int n)	mean
+ *	sll sllvarv(const sll *x, int n, int ddof)
+ *						variance
+ *	sll sllcovv(const sll *x, const sll *y, int n, int ddof)
+ *						covariance
+ *	sll sllcorrv(const sll *x, const sll *y, int n)
+ *						Pearson correlation
+ *	sll sllminv(const sll *x, int n)	minimum
+ *	sll sllmaxv(const sll *x, int n)	maximum
+ *	int sllargminv(const sll *x, int n)	index of the first minimum
+ *	int sllargmaxv(const sll *x, int n)	index of the first maximum
+ *
+ * Regression
+ *
+ *	Least-squares fits.  Sums of products are wide accumulations and the
+ *	normal equations are solved by Cholesky decomposition.  A polynomial
+ *	is fitted in x mapped onto [-1, 1], which keeps the normal equations
+ *	well scaled, and is then converted back to coefficients of x, lowest
+ *	first.  Those carry 32 fraction bits, so with large x the high
+ *	coefficients lose precision, and fitting in x - x0 may be better.
+ *	The degree must be less than SLLFIT_MAX, which defaults to 8 and may
+ *	be overridden at compile time.  Batched fits share x over m series of
+ *	n samples each, y[j * n + i].  The fits return 0 if the samples don't
+ *	determine them or a coefficient doesn't fit in sll, 1 otherwise.
+ *
+ *	A streaming fit accumulates exact sums of the samples, relative to
+ *	the first, so samples can also be removed, for a sliding window.
+ *
+ *	int sllfitline(sll *a, sll *b, const sll *x, const sll *y, int n)
+ *						y = a + b * x
+ *	int sllfitlinev(sll *a, sll *b, const sll *x, const sll *y, int n,
+ *			int m)			m lines
+ *	int sllfitpoly(sll *c, const sll *x, const sll *y, int n, int deg)
+ *						y = SUM c[k] * x^k
+ *	int sllfitpolyv(sll *c, const sll *x, const sll *y, int n, int deg,
+ *			int m)			m polynomials, c is m x (deg + 1)
+ *	void sllfitinit(sllfit *f)
+ *	void sllfitadd(sllfit *f, sll x, sll y)	add a sample
+ *	void sllfitremove(sllfit *f, sll x, sll y)
+ *						remove a sample
+ *	int sllfitget(const sllfit *f, sll *a, sll *b)
+ *						y = a + b * x
+ *
+ * Streaming statistics
+ *
+ *	O(1) per sample over a sliding window, in caller-supplied ring buffers
+ *	of size elements.  Until the window fills, results are over the
+ *	samples seen so far.
+ *
+ *	The moving average keeps an exact wide sum, adding the new sample and
+ *	removing the oldest, so it never drifts.  The rolling variance keeps
+ *	exact sums of deviations from a reference, which is moved to the
+ *	window mean each time the buffer wraps, so cancellation stays small.
+ *	An EMA whose alpha is a power of 2 updates with a shift.  The rolling
+ *	minimum and maximum keep a monotonic deque of candidates.
+ *
+ *	void sllsmainit(sllsma *s, sll *buf, int size)
+ *	sll sllsmastep(sllsma *s, sll x)	moving average
+ *	void sllsmabankinit(sllsmabank *b, sll *buf, sllacc *sum, int n,
+ *			int size)		n series, buf is n * size
+ *	void sllsmabankstep(sllsmabank *b, sll *mean, const sll *x)
+ *						moving averages of n series
+ *	void sllemainit(sllema *e, sll alpha)
+ *	sll sllemastep(sllema *e, sll x)	exponential moving average
+ *	void sllemastepv(sll *y, const sll *x, sll alpha, int n)
+ *						n exponential moving averages y
+ *	void sllrvarinit(sllrvar *v, sll *buf, int size, int ddof)
+ *	sll sllrvarstep(sllrvar *v, sll x)	rolling variance
+ *	void sllrollinit(sllroll *r, sll *val, unsigned *seq, int size,
+ *			int ismax)
+ *	sll sllrollstep(sllroll *r, sll x)	rolling minimum, or maximum if
+ *						ismax
+ *
+ * Histograms
+ *
+ *	Counts go in a caller-supplied array of nbins.  Uniform bins split
+ *	[lo, hi) evenly, and a sample is binned exactly, by a multiply with a
+ *	reciprocal prepared at init and a check against the next bin edge.
+ *	The range may be as wide as sll allows.  Log-scale bins start at
+ *	lo > 0 with per_octave bins to each doubling, binned by slllog2().
+ *	Samples outside the bins are counted in under and over.  Partial
+ *	histograms, from blocks of data or threads, with the same bins
+ *	combine with sllhistmerge().  With hi <= lo there are no uniform
+ *	bins, and every sample is under or over.
+ *
+ *	void sllhistinit(sllhist *h, unsigned *count, int nbins, sll lo,
+ *			sll hi)			uniform bins
+ *	void sllhistloginit(sllhist *h, unsigned *count, int nbins, sll lo,
+ *			int per_octave)		log-scale bins
+ *	void sllhistclear(sllhist *h)		zero the counts
+ *	int sllhistbin(const sllhist *h, sll x)	bin of x, -1 below, nbins above
+ *	void sllhistbinv(const sllhist *h, int *bin, const sll *x, int n)
+ *						bins of n samples
+ *	void sllhistaddv(sllhist *h, const sll *x, int n)
+ *						count n samples
+ *	void sllhistmerge(sllhist *h, const sllhist *o)
+ *						add the counts of o
+ *
+ * Matrices
+ *
+ *	Matrices are row-major arrays of sll.  Every element of a product is
+ *	a wide accumulation, chopped once.
+ *
+ *	void sllmatmul(sll *c, const sll *a, const sll *b, int n, int m, int p)
+ *						c = a * b, a is n x m, b is m x p
+ *	void sllmatmult(sll *c, const sll *a, const sll *b, int n, int m,
+ *			int p)			c = a * b^T, a is n x m, b is p x m
+ *	int sllcholesky(sll *l, const sll *a, int n)
+ *						a = l * l^T, a is n x n
+ *						returns 0 if a isn't positive
+ *						definite
+ *	void sllcholsolve(sll *x, const sll *l, const sll *b, int n, int p)
+ *						solve l * l^T * x = b, b is n x p
+ *
+ * Random numbers
+ *
+ *	xoshiro256** by Blackman and Vigna, seeded through splitmix64, so any
+ *	64 bit seed is good.  Uniform values come straight from the top 32
+ *	bits of the generator, with no conversion through double.
+ *
+ *	void sllrngseed(sllrng *r, ull seed)	seed the generator
+ *	ull sllrngnext(sllrng *r)		next 64 random bits
+ *	sll sllrand(sllrng *r)			uniform, 0 <= x < 1
+ *	sll sllrandrange(sllrng *r, sll lo, sll hi)
+ *						uniform, lo <= x < hi
+ *	sll sllrandnorm(sllrng *r)		standard normal
+ *	sll sllrandexp(sllrng *r)		exponential, mean 1
+ *	void sllrandv(sllrng *r, sll *x, int n)	n uniform values
+ *	void sllrandnormv(sllrng *r, sll *x, int n)
+ *						n standard normal values
+ *
+ * Roots and minima
+ *
+ *	Bracketing solvers need f(a) and f(b) of opposite signs.  All of them
+ *	stop within tol of the answer, or at the 2^-32 grid if tol is 0, or
+ *	after maxit evaluations.  A vector function evaluates many independent
+ *	functions at once, one per element, for the batched solver.
+ *
+ *	sll sllbrent(sllfn f, void *ctx, sll a, sll b, sll tol, int maxit)
+ *						root by Brent's method
+ *	sll sllillinois(sllfn f, void *ctx, sll a, sll b, sll tol, int maxit)
+ *						root by the Illinois method
+ *	sll sllnewton(sllfn f, sllfn df, void *ctx, sll x, sll tol, int maxit)
+ *						root by Newton's method, df is f'
+ *	sll sllgolden(sllfn f, void *ctx, sll a, sll b, sll tol, int maxit)
+ *						minimum of a unimodal f on [a, b]
+ *	void sllillinoisv(sllfnv f, void *ctx, sll *x, sll *a, sll *b, int n,
+ *			sll tol, int maxit, sll *work)
+ *						n roots by the Illinois method,
+ *						a and b are clobbered, work is 3 * n
+ *
+ * Differential equations
+ *
+ *	State vectors are arrays of n sll, laid out however the caller likes,
+ *	so many bodies are integrated in one call by making n cover all of
+ *	them.  Work arrays are supplied by the caller.  Each new state value is
+ *	a wide accumulation, chopped once, to limit drift over long runs.
+ *
+ *	A first order system dy/dt = f(t, y) is an sllodefn, and a second
+ *	order system d2x/dt2 = a(x) is an sllaccelfn, both with an opaque
+ *	context pointer.
+ *
+ *	void sllrk4(sllodefn f, void *ctx, sll *y, sll t, sll h, int n,
+ *			sll *work)		classic Runge-Kutta step, work is
+ *						5 * n
+ *	void sllsieuler(sllaccelfn a, void *ctx, sll *x, sll *v, sll h,
+ *			int n, sll *work)	semi-implicit Euler step, work is n
+ *	void sllverlet(sllaccelfn a, void *ctx, sll *x, sll *v, sll *acc,
+ *			sll h, int n)		velocity Verlet step, acc holds
+ *						a(x) on entry and on return
+ *	void sllodelin(sll *dydt, sll t, const sll *y, int n, void *ctx)
+ *						linear system dy/dt = A * y, where
+ *						ctx points at the n x n matrix A
+ *
+ * Integration
+ *
+ *	Sampled forms take n samples y spaced h apart, or at abscissae x.
+ *	Weighted sums are wide accumulations of exact products, chopped once.
+ *	A function to integrate is an sllfn with an opaque context pointer.
+ *
+ *	sll slltrapz(const sll *y, int n, sll h)
+ *						trapezoid rule
+ *	sll slltrapzx(const sll *x, const sll *y, int n)
+ *						trapezoid rule, any spacing
+ *	sll sllsimps(const sll *y, int n, sll h)
+ *						Simpson's rule, with a 3/8 rule
+ *						panel at the end when n is even
+ *	sll sllgauss(sllfn f, void *ctx, sll a, sll b, int m)
+ *						5 point Gauss-Legendre, m panels
+ *	sll sllasimps(sllfn f, void *ctx, sll a, sll b, sll eps, int depth)
+ *						adaptive Simpson's rule, to within
+ *						eps, at most depth bisections
+ *
+ * Interpolation
+ *
+ *	Piecewise cubic Hermite curves through knots x (increasing) and y,
+ *	given the slope d at each knot.  A cubic spline or PCHIP sets d from
+ *	the knots.  The spline has a continuous second derivative, and is
+ *	natural, with zero second derivative at the ends, or clamped to end
+ *	slopes d0 and d1.  Solving for it needs a work array of n.  PCHIP
+ *	doesn't overshoot:  it is monotone wherever the data are.
+ *
+ *	Evaluation finds the interval by binary search, or for uniform knots
+ *	x0 + i * h directly from (x - x0) / h, which also gives the position
+ *	within it.  Sorted queries are evaluated in one merged scan of the
+ *	knots.  Queries outside the knots take the end values.
+ *
+ *	void sllspline(sll *d, const sll *x, const sll *y, sll *work, int n)
+ *						natural cubic spline
+ *	void sllsplinec(sll *d, const sll *x, const sll *y, sll *work, int n,
+ *			sll d0, sll d1)		clamped cubic spline
+ *	void sllpchip(sll *d, const sll *x, const sll *y, int n)
+ *						monotone cubic, Fritsch-Carlson
+ *	sll sllinterp(const sll *x, const sll *y, const sll *d, int n, sll xq)
+ *						curve at xq
+ *	sll sllinterpu(const sll *y, const sll *d, int n, sll x0, sll h,
+ *			sll xq)			curve with uniform knots at xq
+ *	void sllinterpv(sll *yq, const sll *xq, int m, const sll *x,
+ *			const sll *y, const sll *d, int n)
+ *						curve at m sorted xq
+ *	void sllinterpuv(sll *yq, const sll *xq, int m, const sll *y,
+ *			const sll *d, int n, sll x0, sll h)
+ *						curve with uniform knots at m xq
+ *
+ * Activations
+ *
+ *	Activation functions for neural networks.  They share an e^x that
+ *	reduces x by powers of 2, which are shifts, rather than powers of e.
+ *	prec chooses SLLACT_FULL, near the precision of sll, or SLLACT_FAST,
+ *	about 16 bits, with shorter polynomials and fewer Newton steps.
+ *	GELU takes the tanh approximation of x * PHI(x), good to about 5e-4.
+ *	Softmax subtracts the largest x, so every e^x is at most 1, and
+ *	divides by their wide sum.
+ *
+ *	sll sllsigmoid(sll x)			1 / (1 + e^-x)
+ *	sll sllsoftplus(sll x)			ln(1 + e^x)
+ *	sll sllgelu(sll x)			x * PHI(x)
+ *	void sllsigmoidv(sll *y, const sll *x, int n, int prec)
+ *	void slltanhv(sll *y, const sll *x, int n, int prec)
+ *	void sllgeluv(sll *y, const sll *x, int n, int prec)
+ *	void sllsoftplusv(sll *y, const sll *x, int n, int prec)
+ *	void sllsoftmaxv(sll *y, const sll *x, int n, int prec)
+ *
+ * Layers
+ *
+ *	Neural network layers.  Each output is a wide accumulation of the
+ *	bias and the exact products, chopped once, then passed through the
+ *	activation act at precision prec, so no extra pass is needed.  act is
+ *	SLLACT_LINEAR, SLLACT_RELU, SLLACT_SIGMOID, SLLACT_TANH, SLLACT_GELU
+ *	or SLLACT_SOFTPLUS.  The bias may be NULL.
+ *
+ *	A dense layer has weights w (p x m), a row for each output.  An sllconv
+ *	describes a convolution:  channels in and out, kernel size, stride,
+ *	zero padding and weights w (cout x cin x kh x kw).  Signals are
+ *	channel-major, and an output has (n + 2 * pad - k) / stride + 1
+ *	samples along a side of n.  A 1D convolution takes kw only.
+ *
+ *	Batch normalization after a layer folds into its weights and bias,
+ *	given cout outputs of per weights each.  b must not be NULL.
+ *
+ *	void slldense(sll *y, const sll *x, const sll *w, const sll *b, int n,
+ *			int m, int p, int act, int prec)
+ *						y = act(x * w^T + b), x is n x m
+ *	void sllconv1d(const sllconv *c, sll *y, const sll *x, int len)
+ *						x is cin x len
+ *	void sllconv2d(const sllconv *c, sll *y, const sll *x, int h, int w)
+ *						x is cin x h x w
+ *	void sllbnfold(sll *w, sll *b, const sll *gamma, const sll *beta,
+ *			const sll *mean, const sll *var, sll eps, int cout,
+ *			int per)		fold batch normalization
+ *
+ * Normalization
+ *
+ *	Normalization of rows of n.  The sums are wide, and each row takes one
+ *	reciprocal square root, so each element is a subtraction and two
+ *	multiplies.  gamma and beta, of n, may be NULL.  y may be the same as
+ *	x.
+ *
+ *	void slllayernorm(sll *y, const sll *x, const sll *gamma,
+ *			const sll *beta, int rows, int n, sll eps)
+ *						(x - mean) / (var + eps)^(1 / 2)
+ *						* gamma + beta
+ *	void sllrmsnorm(sll *y, const sll *x, const sll *gamma, int rows,
+ *			int n, sll eps)		x / (mean(x^2) + eps)^(1 / 2)
+ *						* gamma
+ *
+ * Quantization
+ *
+ *	Bulk conversions round to nearest, ties to even, and saturate, where
+ *	dbl2sll() and sll2dbl() truncate.  Floating point values are unpacked
+ *	and packed bit by bit, as in dbl2sll(), so no floating point arithmetic
+ *	is done.  Infinities saturate and NaN gives 0.  Q16.16 values are int,
+ *	rounded half up.
+ *
+ *	int8 values are q = x / scale + zero, saturated to -128 to 127.  The
+ *	scale is one for the tensor, or one for each of c channels of per
+ *	contiguous values, with zero points zero, which may be NULL for 0.
+ *	A range lo to hi, from sllminv() and sllmaxv(), or from percentiles
+ *	to ignore outliers, gives a scale and zero point.  A symmetric range
+ *	has zero point 0, and maps the larger magnitude to 127.
+ *
+ *	void dbl2sllv(sll *y, const double *x, int n)
+ *	void flt2sllv(sll *y, const float *x, int n)
+ *	void sll2dblv(double *y, const sll *x, int n)
+ *	void sll2fltv(float *y, const sll *x, int n)
+ *	void sll2q16v(int *y, const sll *x, int n)
+ *	void q162sllv(sll *y, const int *x, int n)
+ *	void sllquant8(signed char *q, const sll *x, int n, sll scale,
+ *			int zero)		int8, one scale
+ *	void sllquant8c(signed char *q, const sll *x, int c, int per,
+ *			const sll *scale, const int *zero)
+ *						int8, a scale for each channel
+ *	void slldequant8(sll *x, const signed char *q, int n, sll scale,
+ *			int zero)
+ *	void slldequant8c(sll *x, const signed char *q, int c, int per,
+ *			const sll *scale, const int *zero)
+ *	void sllq8range(sll *scale, int *zero, sll lo, sll hi, int symmetric)
+ *						int8 scale and zero point
+ *	sll sllpercentile(sll *x, int n, sll p)	p-th quantile, 0 <= p <= 1,
+ *						interpolated, reorders x
+ *
+ * Kalman filter
+ *
+ *	An sllkf points at caller-owned arrays:  the state x (n), covariance
+ *	p (n x n), transition f (n x n), process noise q (n x n), measurement
+ *	h (m x n) and measurement noise r (m x m).  Scratch space is on the
+ *	stack, so n and m must not exceed SLLKF_MAX, which defaults to 8 and
+ *	may be overridden at compile time.
+ *
+ *	void sllkfpredict(sllkf *k)		x = f * x, p = f * p * f^T + q
+ *	int sllkfupdate(sllkf *k, const sll *z)	measurement update, Joseph form
+ *						returns 0 if the innovation
+ *						covariance isn't positive definite
+ *	void sllkfpredictv(sllkf *k, int count)	sllkfpredict() over filters
+ *	int sllkfupdatev(sllkf *k, const sll *z, int count)
+ *						sllkfupdate() over filters, z holds
+ *						m values per filter, returns the
+ *						number updated
+ *
+ * Angles
+ *
+ *	A binary angle (BAM) is an unsigned 32 bit integer where 2^32 is one
+ *	full turn, so wrap-around is free and the quadrant is the top 2 bits.
+ *
+ *	sll slldeg2rad(sll x)			degrees to radians
+ *	sll sllrad2deg(sll x)			radians to degrees
+ *	sll bam2sll(unsigned a)			binary angle to radians
+ *	unsigned sll2bam(sll x)			radians to binary angle
+ *	void sllsincosbam(unsigned a, sll *s, sll *c)
+ *						sin a and cos a of a binary angle
+ *
+ * Control
+ *
+ *	A PID controller with the time step folded into the gains:
+ *	ki = Ki * dt and kd = Kd / dt.  The derivative acts on the measurement,
+ *	not the error, so set-point steps don't kick the output, and passes
+ *	through a first order low-pass filter with 0 < alpha <= 1, where 1 is
+ *	no filtering.  The integral is clamped to [imin, imax] and frozen while
+ *	the output is saturated in the direction the error is pushing, and the
+ *	output is clamped to [omin, omax].  All arithmetic saturates.
+ *
+ *	void sllpidreset(sllpid *p, sll pv)	clear state, pv is the measurement
+ *	sll sllpidstep(sllpid *p, sll sp, sll pv)
+ *						one step, returns the output
+ *
+ *	A bank holds many controllers as a structure of arrays, one array per
+ *	field, all of length n.
+ *
+ *	void sllpidbankreset(sllpidbank *b, const sll *pv)
+ *						clear all state
+ *	void sllpidbankstep(sllpidbank *b, sll *out, const sll *sp,
+ *			const sll *pv)		one step of every controller
+ *
+ * Motor control
+ *
+ *	Field-oriented control transforms between three phase currents (a, b, c),
+ *	the stationary two axis frame (alpha, beta) and the rotor frame (d, q).
+ *	The Clarke transform is amplitude-invariant and assumes a + b + c = 0.
+ *	The rotor angle is a binary angle, see sllsincosbam().
+ *
+ *	void sllclarke(sll *alpha, sll *beta, sll a, sll b)
+ *						Clarke transform
+ *	void sllinvclarke(sll *a, sll *b, sll *c, sll alpha, sll beta)
+ *						inverse Clarke transform
+ *	void sllpark(sll *d, sll *q, sll alpha, sll beta, sll s, sll c)
+ *						Park transform, given sin and cos
+ *	void sllinvpark(sll *alpha, sll *beta, sll d, sll q, sll s, sll c)
+ *						inverse Park transform
+ *	void sllclarkepark(sll *d, sll *q, sll a, sll b, unsigned theta)
+ *						phase currents to d, q
+ *	void sllinvparkclarke(sll *a, sll *b, sll *c, sll d, sll q,
+ *			unsigned theta)		d, q to phase values
+ *	void sllclarkeparkv(sll *d, sll *q, const sll *a, const sll *b,
+ *			const unsigned *theta, int n)
+ *						sllclarkepark() over motors
+ *	void sllinvparkclarkev(sll *a, sll *b, sll *c, const sll *d,
+ *			const sll *q, const unsigned *theta, int n)
+ *						sllinvparkclarke() over motors
+ *
+ * Geodesy
+ *
+ *	Latitudes, longitudes, angles and bearings are in radians.  Multiply a
+ *	central angle by the sphere radius to get a distance.
+ *
+ *	sll sllgcdist(sll lat1, sll lon1, sll lat2, sll lon2)
+ *						great-circle central angle
+ *	sll sllgcbearing(sll lat1, sll lon1, sll lat2, sll lon2)
+ *						initial bearing, -pi < b <= pi
+ *	void sllgcinv(sll *d, sll *b, sll lat1, sll lon1, sll lat2, sll lon2)
+ *						central angle and bearing together
+ *	void sllgcdistv(sll *d, const sll *lat1, const sll *lon1,
+ *			const sll *lat2, const sll *lon2, int n)
+ *						sllgcdist() over arrays
+ *	void sllgcbearingv(sll *b, const sll *lat1, const sll *lon1,
+ *			const sll *lat2, const sll *lon2, int n)
+ *						sllgcbearing() over arrays
+ *
+ *	Positions on the WGS 84 ellipsoid are in metres.  Earth-centred,
+ *	Earth-fixed (ECEF) coordinates are at most about 6.4e6 in magnitude,
+ *	which fits comfortably, with 2^-32 metre resolution.  A local
+ *	east-north-up (ENU) frame is prepared once with sllenuinit().
+ *
+ *	void sllgeo2ecef(sll *x, sll *y, sll *z, sll lat, sll lon, sll h)
+ *						geodetic to ECEF
+ *	void sllecef2geo(sll *lat, sll *lon, sll *h, sll x, sll y, sll z)
+ *						ECEF to geodetic
+ *	void sllenuinit(sllenu *f, sll lat, sll lon, sll h)
+ *						ENU frame at a geodetic origin
+ *	void sllecef2enu(const sllenu *f, sll *e, sll *n, sll *u,
+ *			sll x, sll y, sll z)	ECEF to ENU
+ *	void sllenu2ecef(const sllenu *f, sll *x, sll *y, sll *z,
+ *			sll e, sll n, sll u)	ENU to ECEF
+ *	void sllgeo2ecefv(sll *x, sll *y, sll *z, const sll *lat,
+ *			const sll *lon, const sll *h, int n)
+ *						sllgeo2ecef() over arrays
+ *	void sllecef2geov(sll *lat, sll *lon, sll *h, const sll *x,
+ *			const sll *y, const sll *z, int n)
+ *						sllecef2geo() over arrays
+ *	void sllecef2enuv(const sllenu *f, sll *e, sll *n, sll *u,
+ *			const sll *x, const sll *y, const sll *z, int count)
+ *						sllecef2enu() over arrays
+ *
  * Macros
  *
  *	Use of the following macros is optional, but may be beneficial with
@@ -181,6 +732,190 @@
 __extension__ typedef signed long long sll;
 __extension__ typedef unsigned long long  ull;
 
+/* 64.64 accumulator, see sllaccmac() */
+typedef struct {
+	sll hi;			// Integer part
+	ull lo;			// Fractional part
+} sllacc;
+
+/* Powers of one base, see sllpowxinit() */
+typedef struct {
+	sll x;
+	sll ln;			// ln x
+} sllpowx;
+
+/* Powers with one exponent, see sllpowyinit() */
+typedef struct {
+	sll y;
+	int kind;		// Method
+	int n;			// Integral y
+	const sll *lut;		// x^y at x = i / 2^bits, or NULL
+	int bits;
+} sllpowy;
+
+/* Streaming line fit, see sllfitadd() */
+#if !defined(SLLFIT_MAX)
+#  define SLLFIT_MAX	8
+#endif
+
+typedef struct {
+	int n;			// Samples
+	sll x0, y0;		// First sample
+	sllacc sx, sy;		// SUM x - x0, SUM y - y0
+	sllacc sxx, sxy;	// SUM (x - x0)^2, SUM (x - x0) * (y - y0)
+} sllfit;
+
+/* Moving average, see sllsmastep() */
+typedef struct {
+	sll *buf;		// Ring buffer
+	int size;		// Window
+	int pos;		// Next slot
+	int count;		// Samples in the window
+	sllacc sum;		// Exact sum of the window
+} sllsma;
+
+/* Moving averages of many series, see sllsmabankstep() */
+typedef struct {
+	int n;			// Series
+	int size;
+	int pos;
+	int count;
+	sll *buf;		// size rows of n samples
+	sllacc *sum;		// n sums
+} sllsmabank;
+
+/* Exponential moving average, see sllemastep() */
+typedef struct {
+	sll y;			// Average
+	sll alpha;		// Weight of a new sample
+	int shift;		// alpha = 2^-shift, or -1
+	int primed;		// y holds a sample
+} sllema;
+
+/* Rolling variance, see sllrvarstep() */
+typedef struct {
+	sll *buf;
+	int size;
+	int pos;
+	int count;
+	int ddof;
+	sll ref;		// Reference the sums are taken from
+	sllacc s1;		// SUM (x - ref)
+	sllacc s2;		// SUM (x - ref)^2
+} sllrvar;
+
+/* Rolling minimum or maximum, see sllrollstep() */
+typedef struct {
+	sll *val;		// Deque of candidates
+	unsigned *seq;		// Their sample numbers
+	int size;
+	int head;		// Front of the deque
+	int count;		// Candidates
+	unsigned t;		// Sample number
+	int ismax;
+} sllroll;
+
+/* Histogram, see sllhistinit() */
+typedef struct {
+	sll lo;			// Start of the first bin
+	sll hi;			// End of the last uniform bin
+	sll scale;		// log2(lo) if per_octave
+	ull recip;		// 2^64 * nbins / (hi - lo), or 0
+	int nbins;
+	int per_octave;		// Bins per doubling, 0 for uniform bins
+	unsigned *count;	// nbins counts
+	unsigned under;		// Samples below the bins
+	unsigned over;		// Samples above the bins
+} sllhist;
+
+/* PID controller, see sllpidstep() */
+typedef struct {
+	sll kp, ki, kd;		// Gains, dt folded into ki and kd
+	sll alpha;		// Derivative filter coefficient
+	sll imin, imax;		// Integral limits
+	sll omin, omax;		// Output limits
+	sll i;			// Integral state
+	sll d;			// Filtered derivative state
+	sll pv;			// Previous measurement
+} sllpid;
+
+/* Bank of PID controllers, see sllpidbankstep() */
+typedef struct {
+	int n;
+	sll *kp, *ki, *kd;
+	sll *alpha;
+	sll *imin, *imax;
+	sll *omin, *omax;
+	sll *i;
+	sll *d;
+	sll *pv;
+} sllpidbank;
+
+/* Random number generator, see sllrngseed() */
+typedef struct {
+	ull s[4];		// xoshiro256** state
+	sll spare;		// Second normal from the last Box-Muller pair
+	int has_spare;
+} sllrng;
+
+/* Function of one variable, see sllgauss() */
+typedef sll (*sllfn)(sll x, void *ctx);
+
+/* Many functions of one variable each, see sllillinoisv() */
+typedef void (*sllfnv)(sll *fx, const sll *x, int n, void *ctx);
+
+/* Differential equations, see sllrk4() and sllverlet() */
+typedef void (*sllodefn)(sll *dydt, sll t, const sll *y, int n, void *ctx);
+typedef void (*sllaccelfn)(sll *a, const sll *x, int n, void *ctx);
+
+/* Activation precision, see sllsigmoidv() */
+#define SLLACT_FAST	0
+#define SLLACT_FULL	1
+
+/* Layer activations, see slldense() */
+#define SLLACT_LINEAR	0
+#define SLLACT_RELU	1
+#define SLLACT_SIGMOID	2
+#define SLLACT_TANH	3
+#define SLLACT_GELU	4
+#define SLLACT_SOFTPLUS	5
+
+/* Convolution layer, see sllconv2d() */
+typedef struct {
+	int cin;		// Input channels
+	int cout;		// Output channels
+	int kh, kw;		// Kernel size
+	int stride;
+	int pad;		// Zeros around the input
+	const sll *w;		// Weights, cout x cin x kh x kw
+	const sll *b;		// Bias, cout, or NULL
+	int act;		// Activation
+	int prec;		// Activation precision
+} sllconv;
+
+/* Kalman filter, see sllkfupdate() */
+#if !defined(SLLKF_MAX)
+#  define SLLKF_MAX	8
+#endif
+
+typedef struct {
+	int n;			// State size
+	int m;			// Measurement size
+	sll *x;			// State
+	sll *p;			// Covariance
+	const sll *f;		// Transition
+	const sll *q;		// Process noise
+	const sll *h;		// Measurement
+	const sll *r;		// Measurement noise
+} sllkf;
+
+/* Local east-north-up frame, see sllenuinit() */
+typedef struct {
+	sll x0, y0, z0;		// Origin in ECEF
+	sll slat, clat;		// sin and cos of origin latitude
+	sll slon, clon;		// sin and cos of origin longitude
+} sllenu;
+
 /*
  * Function prototypes
  */
@@ -217,10 +952,12 @@ static __inline__ sll slldiv2n(sll x, int n);
 sll sllcos(sll x);
 sll sllsin(sll x);
 sll slltan(sll x);
+void sllsincos(sll x, sll *s, sll *c);
 
 static __inline__ sll sllacos(sll x);
 sll sllasin(sll x);
 sll sllatan(sll x);
+sll sllatan2(sll y, sll x);
 
 static __inline__ sll sllsec(sll x);
 static __inline__ sll sllcsc(sll x);
@@ -236,14 +973,249 @@ static __inline__ sll sllcoth(sll x);
 
 sll sllexp(sll x);
 sll slllog(sll x);
+sll sllexp2(sll x);
+sll slllog2(sll x);
+sll sllexp10(sll x);
+sll slllog10(sll x);
+sll sllexpm1(sll x);
+sll slllog1p(sll x);
+void sllexp2v(sll *y, const sll *x, int n);
+void slllog2v(sll *y, const sll *x, int n);
+void sllexp10v(sll *y, const sll *x, int n);
+void slllog10v(sll *y, const sll *x, int n);
+void sllexpm1v(sll *y, const sll *x, int n);
+void slllog1pv(sll *y, const sll *x, int n);
 
 sll sllpow(sll x, sll y);
+sll sllpowi(sll x, int n);
+
+void sllpowxinit(sllpowx *p, sll x);
+sll sllpowxeval(const sllpowx *p, sll y);
+void sllpowxv(const sllpowx *p, sll *r, const sll *y, int n);
+void sllpowyinit(sllpowy *p, sll y);
+void sllpowylut(sllpowy *p, sll *lut, int bits);
+sll sllpowyeval(const sllpowy *p, sll x);
+void sllpowyv(const sllpowy *p, sll *r, const sll *x, int n);
 sll sllinv(sll v);
 sll sllsqrt(sll x);
+sll sllrsqrt(sll x);
+sll sllcbrt(sll x);
+sll sllroot(sll x, int n);
+sll sllhypot(sll x, sll y);
+
+sll sllerf(sll x);
+sll sllerfc(sll x);
+sll sllnormcdf(sll x);
+sll sllnorminv(sll p);
+void sllerfv(sll *y, const sll *x, int n);
+void sllerfcv(sll *y, const sll *x, int n);
+void sllnormcdfv(sll *y, const sll *x, int n);
+void sllnorminvv(sll *y, const sll *p, int n);
+
+sll slllgamma(sll x);
+sll sllgamma(sll x);
+sll sllfact(int n);
+sll slllogfact(int n);
+sll sllbinom(int n, int k);
+sll slllogbinom(int n, int k);
+sll sllbinompmf(int n, int k, sll p);
+sll sllpoissonpmf(int k, sll lambda);
+void slllgammav(sll *y, const sll *x, int n);
+void sllgammav(sll *y, const sll *x, int n);
+void sllbinompmfv(sll *y, int n, sll p);
+void sllpoissonpmfv(sll *y, int n, sll lambda);
+
+static __inline__ sll slladdsat(sll x, sll y);
+static __inline__ sll sllsubsat(sll x, sll y);
+sll sllmulsat(sll x, sll y);
+static __inline__ sll sllclamp(sll x, sll lo, sll hi);
 
 static __inline__ sll sllfloor(sll x);
 static __inline__ sll sllceil(sll x);
 
+static __inline__ void sllacczero(sllacc *a);
+void sllaccadd(sllacc *a, sll x);
+void sllaccmac(sllacc *a, sll x, sll y);
+void sllaccmsub(sllacc *a, sll x, sll y);
+static __inline__ sll sllacc2sll(const sllacc *a);
+sll sllaccdivi(const sllacc *a, int d);
+sll sllfma(sll x, sll y, sll z);
+void sllaccmerge(sllacc *a, const sllacc *b);
+
+void sllaccsumv(sllacc *a, const sll *x, int n);
+sll sllsumv(const sll *x, int n);
+sll sllmeanv(const sll *x, int n);
+sll sllvarv(const sll *x, int n, int ddof);
+sll sllcovv(const sll *x, const sll *y, int n, int ddof);
+sll sllcorrv(const sll *x, const sll *y, int n);
+sll sllminv(const sll *x, int n);
+sll sllmaxv(const sll *x, int n);
+int sllargminv(const sll *x, int n);
+int sllargmaxv(const sll *x, int n);
+
+void sllmatmul(sll *c, const sll *a, const sll *b, int n, int m, int p);
+void sllmatmult(sll *c, const sll *a, const sll *b, int n, int m, int p);
+int sllcholesky(sll *l, const sll *a, int n);
+void sllcholsolve(sll *x, const sll *l, const sll *b, int n, int p);
+
+void sllrngseed(sllrng *r, ull seed);
+ull sllrngnext(sllrng *r);
+sll sllrand(sllrng *r);
+sll sllrandrange(sllrng *r, sll lo, sll hi);
+sll sllrandnorm(sllrng *r);
+sll sllrandexp(sllrng *r);
+void sllrandv(sllrng *r, sll *x, int n);
+void sllrandnormv(sllrng *r, sll *x, int n);
+
+sll sllbrent(sllfn f, void *ctx, sll a, sll b, sll tol, int maxit);
+sll sllillinois(sllfn f, void *ctx, sll a, sll b, sll tol, int maxit);
+sll sllnewton(sllfn f, sllfn df, void *ctx, sll x, sll tol, int maxit);
+sll sllgolden(sllfn f, void *ctx, sll a, sll b, sll tol, int maxit);
+void sllillinoisv(sllfnv f, void *ctx, sll *x, sll *a, sll *b, int n,
+	sll tol, int maxit, sll *work);
+
+void sllrk4(sllodefn f, void *ctx, sll *y, sll t, sll h, int n, sll *work);
+void sllsieuler(sllaccelfn a, void *ctx, sll *x, sll *v, sll h, int n,
+	sll *work);
+void sllverlet(sllaccelfn a, void *ctx, sll *x, sll *v, sll *acc, sll h,
+	int n);
+void sllodelin(sll *dydt, sll t, const sll *y, int n, void *ctx);
+
+sll slltrapz(const sll *y, int n, sll h);
+sll slltrapzx(const sll *x, const sll *y, int n);
+sll sllsimps(const sll *y, int n, sll h);
+sll sllgauss(sllfn f, void *ctx, sll a, sll b, int m);
+sll sllasimps(sllfn f, void *ctx, sll a, sll b, sll eps, int depth);
+
+void sllspline(sll *d, const sll *x, const sll *y, sll *work, int n);
+void sllsplinec(sll *d, const sll *x, const sll *y, sll *work, int n, sll d0,
+	sll d1);
+void sllpchip(sll *d, const sll *x, const sll *y, int n);
+sll sllinterp(const sll *x, const sll *y, const sll *d, int n, sll xq);
+sll sllinterpu(const sll *y, const sll *d, int n, sll x0, sll h, sll xq);
+void sllinterpv(sll *yq, const sll *xq, int m, const sll *x, const sll *y,
+	const sll *d, int n);
+void sllinterpuv(sll *yq, const sll *xq, int m, const sll *y, const sll *d,
+	int n, sll x0, sll h);
+
+sll sllsigmoid(sll x);
+sll sllsoftplus(sll x);
+sll sllgelu(sll x);
+void sllsigmoidv(sll *y, const sll *x, int n, int prec);
+void slltanhv(sll *y, const sll *x, int n, int prec);
+void sllgeluv(sll *y, const sll *x, int n, int prec);
+void sllsoftplusv(sll *y, const sll *x, int n, int prec);
+void sllsoftmaxv(sll *y, const sll *x, int n, int prec);
+
+void slldense(sll *y, const sll *x, const sll *w, const sll *b, int n, int m,
+	int p, int act, int prec);
+void sllconv1d(const sllconv *c, sll *y, const sll *x, int len);
+void sllconv2d(const sllconv *c, sll *y, const sll *x, int h, int w);
+void sllbnfold(sll *w, sll *b, const sll *gamma, const sll *beta,
+	const sll *mean, const sll *var, sll eps, int cout, int per);
+
+void slllayernorm(sll *y, const sll *x, const sll *gamma, const sll *beta,
+	int rows, int n, sll eps);
+void sllrmsnorm(sll *y, const sll *x, const sll *gamma, int rows, int n,
+	sll eps);
+
+void dbl2sllv(sll *y, const double *x, int n);
+void flt2sllv(sll *y, const float *x, int n);
+void sll2dblv(double *y, const sll *x, int n);
+void sll2fltv(float *y, const sll *x, int n);
+void sll2q16v(int *y, const sll *x, int n);
+void q162sllv(sll *y, const int *x, int n);
+void sllquant8(signed char *q, const sll *x, int n, sll scale, int zero);
+void sllquant8c(signed char *q, const sll *x, int c, int per,
+	const sll *scale, const int *zero);
+void slldequant8(sll *x, const signed char *q, int n, sll scale, int zero);
+void slldequant8c(sll *x, const signed char *q, int c, int per,
+	const sll *scale, const int *zero);
+void sllq8range(sll *scale, int *zero, sll lo, sll hi, int symmetric);
+sll sllpercentile(sll *x, int n, sll p);
+
+void sllkfpredict(sllkf *k);
+int sllkfupdate(sllkf *k, const sll *z);
+void sllkfpredictv(sllkf *k, int count);
+int sllkfupdatev(sllkf *k, const sll *z, int count);
+
+static __inline__ sll slldeg2rad(sll x);
+static __inline__ sll sllrad2deg(sll x);
+static __inline__ sll bam2sll(unsigned a);
+static __inline__ unsigned sll2bam(sll x);
+void sllsincosbam(unsigned a, sll *s, sll *c);
+
+sll sllgcdist(sll lat1, sll lon1, sll lat2, sll lon2);
+sll sllgcbearing(sll lat1, sll lon1, sll lat2, sll lon2);
+void sllgcinv(sll *d, sll *b, sll lat1, sll lon1, sll lat2, sll lon2);
+void sllgcdistv(sll *d, const sll *lat1, const sll *lon1,
+	const sll *lat2, const sll *lon2, int n);
+void sllgcbearingv(sll *b, const sll *lat1, const sll *lon1,
+	const sll *lat2, const sll *lon2, int n);
+
+int sllfitline(sll *a, sll *b, const sll *x, const sll *y, int n);
+int sllfitlinev(sll *a, sll *b, const sll *x, const sll *y, int n, int m);
+int sllfitpoly(sll *c, const sll *x, const sll *y, int n, int deg);
+int sllfitpolyv(sll *c, const sll *x, const sll *y, int n, int deg, int m);
+void sllfitinit(sllfit *f);
+void sllfitadd(sllfit *f, sll x, sll y);
+void sllfitremove(sllfit *f, sll x, sll y);
+int sllfitget(const sllfit *f, sll *a, sll *b);
+
+void sllsmainit(sllsma *s, sll *buf, int size);
+sll sllsmastep(sllsma *s, sll x);
+void sllsmabankinit(sllsmabank *b, sll *buf, sllacc *sum, int n, int size);
+void sllsmabankstep(sllsmabank *b, sll *mean, const sll *x);
+void sllemainit(sllema *e, sll alpha);
+sll sllemastep(sllema *e, sll x);
+void sllemastepv(sll *y, const sll *x, sll alpha, int n);
+void sllrvarinit(sllrvar *v, sll *buf, int size, int ddof);
+sll sllrvarstep(sllrvar *v, sll x);
+void sllrollinit(sllroll *r, sll *val, unsigned *seq, int size, int ismax);
+sll sllrollstep(sllroll *r, sll x);
+
+void sllhistinit(sllhist *h, unsigned *count, int nbins, sll lo, sll hi);
+void sllhistloginit(sllhist *h, unsigned *count, int nbins, sll lo,
+	int per_octave);
+void sllhistclear(sllhist *h);
+int sllhistbin(const sllhist *h, sll x);
+void sllhistbinv(const sllhist *h, int *bin, const sll *x, int n);
+void sllhistaddv(sllhist *h, const sll *x, int n);
+void sllhistmerge(sllhist *h, const sllhist *o);
+
+void sllpidreset(sllpid *p, sll pv);
+sll sllpidstep(sllpid *p, sll sp, sll pv);
+void sllpidbankreset(sllpidbank *b, const sll *pv);
+void sllpidbankstep(sllpidbank *b, sll *out, const sll *sp, const sll *pv);
+
+static __inline__ void sllclarke(sll *alpha, sll *beta, sll a, sll b);
+static __inline__ void sllinvclarke(sll *a, sll *b, sll *c,
+	sll alpha, sll beta);
+static __inline__ void sllpark(sll *d, sll *q, sll alpha, sll beta,
+	sll s, sll c);
+static __inline__ void sllinvpark(sll *alpha, sll *beta, sll d, sll q,
+	sll s, sll c);
+void sllclarkepark(sll *d, sll *q, sll a, sll b, unsigned theta);
+void sllinvparkclarke(sll *a, sll *b, sll *c, sll d, sll q, unsigned theta);
+void sllclarkeparkv(sll *d, sll *q, const sll *a, const sll *b,
+	const unsigned *theta, int n);
+void sllinvparkclarkev(sll *a, sll *b, sll *c, const sll *d,
+	const sll *q, const unsigned *theta, int n);
+
+void sllgeo2ecef(sll *x, sll *y, sll *z, sll lat, sll lon, sll h);
+void sllecef2geo(sll *lat, sll *lon, sll *h, sll x, sll y, sll z);
+void sllenuinit(sllenu *f, sll lat, sll lon, sll h);
+void sllecef2enu(const sllenu *f, sll *e, sll *n, sll *u,
+	sll x, sll y, sll z);
+void sllenu2ecef(const sllenu *f, sll *x, sll *y, sll *z,
+	sll e, sll n, sll u);
+void sllgeo2ecefv(sll *x, sll *y, sll *z, const sll *lat,
+	const sll *lon, const sll *h, int n);
+void sllecef2geov(sll *lat, sll *lon, sll *h, const sll *x,
+	const sll *y, const sll *z, int n);
+void sllecef2enuv(const sllenu *f, sll *e, sll *n, sll *u,
+	const sll *x, const sll *y, const sll *z, int count);
+
 /*
  * Macros
  *
@@ -273,6 +1245,9 @@ static __inline__ sll sllceil(sll x);
  * Constants (converted from double)
  */
 
+#define CONST_MAX	0x7fffffffffffffffLL	// Largest sll
+#define CONST_MIN	(-CONST_MAX - 1)	// Smallest sll
+
 #define CONST_0		0x0000000000000000LL	// 0.0
 #define CONST_1		0x0000000100000000LL	// 1.0
 #define CONST_2		0x0000000200000000LL 	// 2.0
@@ -292,6 +1267,7 @@ static __inline__ sll sllceil(sll x);
 #define CONST_1_11	0x000000001745d174LL	// 1.0 / 11.0
 #define CONST_1_12	0x0000000015555555LL	// 1.0 / 12.0
 #define CONST_1_20	0x000000000cccccccLL	// 1.0 / 20.0
+#define CONST_1_24	0x000000000aaaaaaaLL	// 1.0 / 24.0
 #define CONST_1_30	0x0000000008888888LL	// 1.0 / 30.0
 #define CONST_1_42	0x0000000006186186LL	// 1.0 / 42.0
 #define CONST_1_56	0x0000000004924924LL	// 1.0 / 56.0
@@ -315,9 +1291,16 @@ static __inline__ sll sllceil(sll x);
 #define CONST_PI_4	0x00000000c90fdaa2LL	// PI / 4
 #define CONST_1_PI	0x00000000517cc1b7LL	// 1 / PI
 #define CONST_2_PI	0x00000000a2f9836eLL	// 2 / PI
+#define CONST_2PI	0x00000006487ed511LL	// 2 * PI
+#define CONST_1_2PI	0x0000000028be60dbLL	// 1 / (2 * PI)
+#define CONST_PI_180	0x000000000477d1a8LL	// PI / 180
+#define CONST_180_PI	0x000000394bb834c7LL	// 180 / PI
 #define CONST_2_SQRTPI	0x0000000120dd7504LL	// 2 / sqrt(PI)
 #define CONST_SQRT2	0x000000016a09e667LL	// sqrt(2)
 #define CONST_1_SQRT2	0x00000000b504f333LL	// 1 / sqrt(2)
+#define CONST_1_PHI	0x000000009e3779b9LL	// 1 / golden ratio
+#define CONST_SQRT3	0x00000001bb67ae85LL	// sqrt(3)
+#define CONST_1_SQRT3	0x0000000093cd3a2cLL	// 1 / sqrt(3)
 
 #define CONST_FACT_0	0x0000000100000000LL	// 0!
 #define CONST_FACT_1	0x0000000100000000LL	// 1!
@@ -333,6 +1316,15 @@ static __inline__ sll sllceil(sll x);
 #define CONST_FACT_11	0x0261150000000000LL	// 11!
 #define CONST_FACT_12	0x1c8cfc0000000000LL	// 12!
 
+/* WGS 84 ellipsoid */
+#define CONST_WGS84_A	0x0061529900000000LL	// a (metres)
+#define CONST_WGS84_B	0x0060ff1050725f40LL	// b (metres)
+#define CONST_WGS84_E2	0x0000000001b6b90fLL	// e^2
+#define CONST_WGS84_1_E2 0x00000000fe4946f0LL	// 1 - e^2
+#define CONST_WGS84_A_B	0x0000000100dc780fLL	// a / b
+#define CONST_WGS84_E2A	0x0000a6c9ac3689a9LL	// e^2 * a
+#define CONST_WGS84_EP2B 0x0000a7594fbf5626LL	// e'^2 * b
+
 /*
  * Convert integer to sll
  */
@@ -822,6 +1814,52 @@ static __inline__ sll sllcoth(sll x)
 	return _slldiv(_slladd(e2x, CONST_1), _sllsub(e2x, CONST_1));
 }
 
+/*
+ * Saturating addition
+ *
+ * Description
+ *
+ *	Overflow happened if both operands have the same sign and the result
+ *	has the other sign.
+ */
+
+static __inline__ sll slladdsat(sll x, sll y)
+{
+	register sll retval;
+
+	retval = (sll) ((ull) x + (ull) y);
+
+	if (((x ^ retval) & (y ^ retval)) < 0)
+		retval = (x < 0) ? CONST_MIN: CONST_MAX;
+
+	return retval;
+}
+
+/*
+ * Saturating subtraction
+ */
+
+static __inline__ sll sllsubsat(sll x, sll y)
+{
+	register sll retval;
+
+	retval = (sll) ((ull) x - (ull) y);
+
+	if (((x ^ y) & (x ^ retval)) < 0)
+		retval = (x < 0) ? CONST_MIN: CONST_MAX;
+
+	return retval;
+}
+
+/*
+ * Clamp to lo <= x <= hi
+ */
+
+static __inline__ sll sllclamp(sll x, sll lo, sll hi)
+{
+	return ((x < lo) ? lo: ((x > hi) ? hi: x));
+}
+
 /*
  * Floor
  *
@@ -856,4 +1894,136 @@ static __inline__ sll sllceil(sll x)
 	return ((retval < x) ? _slladd(retval, CONST_1): retval);
 }
 
+/*
+ * Clear a wide accumulator
+ */
+
+static __inline__ void sllacczero(sllacc *a)
+{
+	a->hi = CONST_0;
+	a->lo = 0;
+}
+
+/*
+ * Wide accumulator to sll
+ *
+ * Description
+ *
+ *	The middle 64 bits of the 64.64 value, which chops.
+ */
+
+static __inline__ sll sllacc2sll(const sllacc *a)
+{
+	return (sll) (((ull) a->hi << 32) | (a->lo >> 32));
+}
+
+/*
+ * Degrees to radians
+ */
+
+static __inline__ sll slldeg2rad(sll x)
+{
+	return sllmul(x, CONST_PI_180);
+}
+
+/*
+ * Radians to degrees
+ */
+
+static __inline__ sll sllrad2deg(sll x)
+{
+	return sllmul(x, CONST_180_PI);
+}
+
+/*
+ * Binary angle to radians, -pi <= x < pi
+ *
+ * Description
+ *
+ *	Reading the binary angle as signed, a * 2^-32 is the fraction of a
+ *	turn, so the raw value of the result is simply a * 2 * pi.
+ */
+
+static __inline__ sll bam2sll(unsigned a)
+{
+	return sllmul((sll) (signed int) a, CONST_2PI);
+}
+
+/*
+ * Radians to binary angle (wraps modulo one turn)
+ */
+
+static __inline__ unsigned sll2bam(sll x)
+{
+	return (unsigned) sllmul(x, CONST_1_2PI);
+}
+
+/*
+ * Clarke transform
+ *
+ * Description
+ *
+ *	alpha = a
+ *	beta = (a + 2 * b) / 3^(1 / 2)
+ */
+
+static __inline__ void sllclarke(sll *alpha, sll *beta, sll a, sll b)
+{
+	*alpha = a;
+	*beta = sllmul(_slladd(a, _sllmul2(b)), CONST_1_SQRT3);
+}
+
+/*
+ * Inverse Clarke transform
+ *
+ * Description
+ *
+ *	a = alpha
+ *	b = (-alpha + 3^(1 / 2) * beta) / 2
+ *	c = (-alpha - 3^(1 / 2) * beta) / 2
+ */
+
+static __inline__ void sllinvclarke(sll *a, sll *b, sll *c,
+	sll alpha, sll beta)
+{
+	register sll t;
+
+	t = sllmul(beta, CONST_SQRT3);
+	*a = alpha;
+	*b = _slldiv2(_sllsub(t, alpha));
+	*c = _slldiv2(_sllneg(_slladd(t, alpha)));
+}
+
+/*
+ * Park transform, given s = sin theta and c = cos theta
+ *
+ * Description
+ *
+ *	d =  alpha * cos theta + beta * sin theta
+ *	q = -alpha * sin theta + beta * cos theta
+ */
+
+static __inline__ void sllpark(sll *d, sll *q, sll alpha, sll beta,
+	sll s, sll c)
+{
+	*d = _slladd(sllmul(alpha, c), sllmul(beta, s));
+	*q = _sllsub(sllmul(beta, c), sllmul(alpha, s));
+}
+
+/*
+ * Inverse Park transform, given s = sin theta and c = cos theta
+ *
+ * Description
+ *
+ *	alpha = d * cos theta - q * sin theta
+ *	beta  = d * sin theta + q * cos theta
+ */
+
+static __inline__ void sllinvpark(sll *alpha, sll *beta, sll d, sll q,
+	sll s, sll c)
+{
+	*alpha = _sllsub(sllmul(d, c), sllmul(q, s));
+	*beta = _slladd(sllmul(d, s), sllmul(q, c));
+}
+
 #endif /* !defined(MATH_SLL_H) */